@@ -0,0 +1,562 @@
+#include "PLSConfigValidator.h"
+
+#if WITH_EDITOR
+
+#include "PLSStreamingBackend.h"
+#include "PLSTypes.h"
+#include "PortalLevelStreaming.h"
+
+#include <Algo/Count.h>
+#include <Algo/Find.h>
+#include <HAL/FileManager.h>
+#include <Misc/FileHelper.h>
+#include <Misc/PackageName.h>
+
+namespace
+{
+    FString EscapeCsv( const FString & value )
+    {
+        return FString::Printf( TEXT( "\"%s\"" ), *value.Replace( TEXT( "\"" ), TEXT( "\"\"" ) ) );
+    }
+
+    int32 CountIssues( const TArray< FPLSValidationIssue > & issues, const EPLSValidationSeverity severity )
+    {
+        return Algo::CountIf( issues, [ severity ]( const auto & issue ) {
+            return issue.Severity == severity;
+        } );
+    }
+}
+
+void FPLSConfigValidator::ValidateStreamingInfos( const FString & owner, const FPLSLevelStreamingInfos & infos, const TSet< FName > * streaming_levels )
+{
+    auto & report = Reports.AddDefaulted_GetRef();
+    report.Owner = owner;
+
+    const auto add_issue = [ &report ]( const EPLSValidationSeverity severity, FString message ) {
+        report.Issues.Add( { severity, MoveTemp( message ) } );
+    };
+
+    // Returns the package name of the streaming level which will be found at runtime, or NAME_None if the level can not be streamed at all
+    const auto resolve_level = [ &add_issue, streaming_levels ]( const FSoftObjectPath & level_path ) {
+        if ( level_path.IsNull() )
+        {
+            add_issue( EPLSValidationSeverity::Error, TEXT( "Empty level reference" ) );
+            return FName( NAME_None );
+        }
+
+        const auto package_name = level_path.GetLongPackageFName();
+
+        if ( !DoesLevelExist( package_name ) )
+        {
+            add_issue( EPLSValidationSeverity::Error, FString::Printf( TEXT( "Level %s does not exist" ), *package_name.ToString() ) );
+            return FName( NAME_None );
+        }
+
+        if ( streaming_levels == nullptr )
+        {
+            return package_name;
+        }
+
+        const auto safe_level_name = FPLSLevelStreamingBackend::MakeSafeLevelName( level_path, nullptr );
+        const auto * streaming_level = Algo::FindByPredicate( *streaming_levels, [ &safe_level_name ]( const FName streaming_level_package_name ) {
+            return FPLSLevelStreamingBackend::IsMatchingStreamingLevel( streaming_level_package_name.ToString(), safe_level_name );
+        } );
+
+        if ( streaming_level == nullptr )
+        {
+            add_issue( EPLSValidationSeverity::Error, FString::Printf( TEXT( "Level %s is not a streaming level of the world and will not be found at runtime" ), *package_name.ToString() ) );
+            return FName( NAME_None );
+        }
+
+        return *streaming_level;
+    };
+
+    TMap< FName, int32 > load_reference_counts;
+
+    const auto add_level_to_load = [ &report, &load_reference_counts, &resolve_level ]( const FSoftObjectPath & level_path ) {
+        const auto package_name = resolve_level( level_path );
+        if ( !package_name.IsNone() )
+        {
+            report.LevelsToLoad.Add( package_name );
+            load_reference_counts.FindOrAdd( package_name )++;
+        }
+    };
+
+    const auto check_level_instance = [ &add_issue ]( const FPLSLevelInstanceInfos & level_instance, int64 * size_on_disk ) {
+        if ( level_instance.Level.IsNull() || !DoesLevelExist( level_instance.Level.ToSoftObjectPath().GetLongPackageFName(), size_on_disk ) )
+        {
+            add_issue( EPLSValidationSeverity::Error, FString::Printf( TEXT( "Level instance %s references a level which does not exist" ), *level_instance.GetInstanceName().ToString() ) );
+            return false;
+        }
+
+        return true;
+    };
+
+    TSet< FName > loaded_level_instances;
+
+    TSet< const UPLSLevelGroup * > loaded_groups;
+    TArray< const UPLSLevelGroup * > groups_to_visit;
+
+    for ( const auto & levels_to_load : infos.LevelsToLoad )
+    {
+        for ( const auto * level_group : levels_to_load.Levels.LevelGroups )
+        {
+            if ( level_group == nullptr )
+            {
+                add_issue( EPLSValidationSeverity::Error, TEXT( "Empty level group in the levels to load" ) );
+                continue;
+            }
+
+            if ( loaded_groups.Contains( level_group ) )
+            {
+                add_issue( EPLSValidationSeverity::Warning, FString::Printf( TEXT( "Level group %s is loaded more than once" ), *level_group->GetName() ) );
+                continue;
+            }
+
+            loaded_groups.Add( level_group );
+            groups_to_visit.Add( level_group );
+        }
+
+        for ( const auto & level_path : levels_to_load.Levels.IndividualLevels )
+        {
+            add_level_to_load( level_path );
+        }
+
+        for ( const auto & level_instance : levels_to_load.Levels.LevelInstances )
+        {
+            int64 size_on_disk = 0;
+            if ( !check_level_instance( level_instance, &size_on_disk ) )
+            {
+                continue;
+            }
+
+            // Each instance is a separate copy of the level
+            report.LoadSizeOnDisk += size_on_disk;
+            loaded_level_instances.Add( level_instance.GetInstanceName() );
+        }
+    }
+
+    // Mirror UPLSRequest : the dependencies of the groups are loaded too
+    for ( auto index = 0; index < groups_to_visit.Num(); ++index )
+    {
+        const auto * level_group = groups_to_visit[ index ];
+
+        for ( const auto & level_path : level_group->Levels )
+        {
+            add_level_to_load( level_path );
+        }
+
+        for ( const auto * dependency : level_group->Dependencies )
+        {
+            if ( dependency != nullptr && !loaded_groups.Contains( dependency ) )
+            {
+                loaded_groups.Add( dependency );
+                groups_to_visit.Add( dependency );
+            }
+        }
+    }
+
+    for ( const auto & pair : load_reference_counts )
+    {
+        if ( pair.Value > 1 )
+        {
+            add_issue( EPLSValidationSeverity::Warning, FString::Printf( TEXT( "Level %s is listed %i times in the levels to load" ), *pair.Key.ToString(), pair.Value ) );
+        }
+    }
+
+    for ( const auto package_name : report.LevelsToLoad )
+    {
+        int64 size_on_disk = 0;
+        DoesLevelExist( package_name, &size_on_disk );
+        report.LoadSizeOnDisk += size_on_disk;
+    }
+
+    if ( infos.UnloadCurrentStreamingLevelsInfos.bUnloadCurrentlyLoadedStreamingLevels )
+    {
+        if ( !infos.LevelsToUnload.IsEmpty() )
+        {
+            add_issue( EPLSValidationSeverity::Warning, TEXT( "The levels to unload are ignored because all the currently loaded streaming levels are unloaded" ) );
+        }
+
+        if ( streaming_levels != nullptr )
+        {
+            report.LevelsToUnload = streaming_levels->Difference( report.LevelsToLoad );
+        }
+    }
+    else
+    {
+        const auto add_level_to_unload = [ &report, &add_issue, &resolve_level ]( const FSoftObjectPath & level_path ) {
+            const auto package_name = resolve_level( level_path );
+            if ( package_name.IsNone() )
+            {
+                return;
+            }
+
+            if ( report.LevelsToLoad.Contains( package_name ) )
+            {
+                add_issue( EPLSValidationSeverity::Warning, FString::Printf( TEXT( "Level %s is both loaded and unloaded : the unload is ignored" ), *package_name.ToString() ) );
+                return;
+            }
+
+            report.LevelsToUnload.Add( package_name );
+        };
+
+        for ( const auto & levels_to_unload : infos.LevelsToUnload )
+        {
+            for ( const auto * level_group : levels_to_unload.Levels.LevelGroups )
+            {
+                if ( level_group == nullptr )
+                {
+                    add_issue( EPLSValidationSeverity::Error, TEXT( "Empty level group in the levels to unload" ) );
+                    continue;
+                }
+
+                for ( const auto & level_path : level_group->Levels )
+                {
+                    add_level_to_unload( level_path );
+                }
+            }
+
+            for ( const auto & level_path : levels_to_unload.Levels.IndividualLevels )
+            {
+                add_level_to_unload( level_path );
+            }
+
+            for ( const auto & level_instance : levels_to_unload.Levels.LevelInstances )
+            {
+                if ( check_level_instance( level_instance, nullptr ) && loaded_level_instances.Contains( level_instance.GetInstanceName() ) )
+                {
+                    add_issue( EPLSValidationSeverity::Warning, FString::Printf( TEXT( "Level instance %s is both loaded and unloaded : the unload is ignored" ), *level_instance.GetInstanceName().ToString() ) );
+                }
+            }
+        }
+
+        if ( infos.LevelsToLoad.IsEmpty() && infos.LevelsToUnload.IsEmpty() )
+        {
+            add_issue( EPLSValidationSeverity::Warning, TEXT( "Nothing to load nor to unload" ) );
+        }
+    }
+}
+
+void FPLSConfigValidator::ValidateLevelGroup( const UPLSLevelGroup & level_group )
+{
+    const auto group_name = level_group.GetPathName();
+
+    if ( LevelGroupIssues.Contains( group_name ) )
+    {
+        return;
+    }
+
+    ValidateLevelGroup( level_group, LevelGroupIssues.Add( group_name ) );
+
+    for ( const auto & level_path : level_group.Levels )
+    {
+        if ( !level_path.IsNull() )
+        {
+            LevelToGroupsMap.FindOrAdd( level_path.GetLongPackageFName() ).AddUnique( group_name );
+        }
+    }
+}
+
+void FPLSConfigValidator::ComputeOverlaps()
+{
+    SharedLevelIssues.Reset();
+
+    for ( auto & report : Reports )
+    {
+        report.MaxOverlap = 0.0f;
+        report.MaxOverlapOwner.Reset();
+
+        if ( report.LevelsToLoad.IsEmpty() )
+        {
+            continue;
+        }
+
+        for ( const auto & other_report : Reports )
+        {
+            if ( &other_report == &report )
+            {
+                continue;
+            }
+
+            const auto overlap = static_cast< float >( report.LevelsToLoad.Intersect( other_report.LevelsToLoad ).Num() ) / report.LevelsToLoad.Num();
+
+            if ( overlap > report.MaxOverlap )
+            {
+                report.MaxOverlap = overlap;
+                report.MaxOverlapOwner = other_report.Owner;
+            }
+        }
+    }
+
+    for ( const auto & pair : LevelToGroupsMap )
+    {
+        if ( pair.Value.Num() > 1 )
+        {
+            for ( const auto & group_name : pair.Value )
+            {
+                SharedLevelIssues.FindOrAdd( group_name ).Add( { EPLSValidationSeverity::Warning, FString::Printf( TEXT( "Level %s is shared by %i groups : %s" ), *pair.Key.ToString(), pair.Value.Num(), *FString::Join( pair.Value, TEXT( ", " ) ) ) } );
+            }
+        }
+    }
+}
+
+void FPLSConfigValidator::LogReport() const
+{
+    const auto log_issues = []( const FString & owner, const TArray< FPLSValidationIssue > & issues ) {
+        for ( const auto & issue : issues )
+        {
+            if ( issue.Severity == EPLSValidationSeverity::Error )
+            {
+                UE_LOG( LogPLS, Error, TEXT( "%s : %s" ), *owner, *issue.Message );
+            }
+            else
+            {
+                UE_LOG( LogPLS, Warning, TEXT( "%s : %s" ), *owner, *issue.Message );
+            }
+        }
+    };
+
+    for ( const auto & pair : LevelGroupIssues )
+    {
+        log_issues( pair.Key, GetLevelGroupIssues( pair.Key ) );
+    }
+
+    for ( const auto & report : Reports )
+    {
+        log_issues( report.Owner, report.Issues );
+
+        UE_LOG( LogPLS, Display, TEXT( "%s : %i levels to load (%.2f MB), %i levels to unload, %.0f%% overlap with %s" ),
+            *report.Owner,
+            report.LevelsToLoad.Num(),
+            report.LoadSizeOnDisk / ( 1024.0 * 1024.0 ),
+            report.LevelsToUnload.Num(),
+            report.MaxOverlap * 100.0f,
+            report.MaxOverlapOwner.IsEmpty() ? TEXT( "nothing" ) : *report.MaxOverlapOwner );
+    }
+
+    UE_LOG( LogPLS, Display, TEXT( "%i streaming configs, %i level groups : %i errors, %i warnings" ), Reports.Num(), LevelGroupIssues.Num(), GetErrorCount(), GetWarningCount() );
+}
+
+bool FPLSConfigValidator::SaveReport( const FString & file_path ) const
+{
+    TArray< FString > lines;
+    lines.Add( TEXT( "Owner,LevelsToLoad,LevelsToUnload,LoadSizeMB,MaxOverlapPercent,MaxOverlapOwner,Errors,Warnings,Issues" ) );
+
+    const auto join_issues = []( const TArray< FPLSValidationIssue > & issues ) {
+        return FString::JoinBy( issues, TEXT( " | " ), []( const auto & issue ) {
+            return issue.Message;
+        } );
+    };
+
+    for ( const auto & report : Reports )
+    {
+        lines.Add( FString::Printf( TEXT( "%s,%i,%i,%.2f,%.0f,%s,%i,%i,%s" ),
+            *EscapeCsv( report.Owner ),
+            report.LevelsToLoad.Num(),
+            report.LevelsToUnload.Num(),
+            report.LoadSizeOnDisk / ( 1024.0 * 1024.0 ),
+            report.MaxOverlap * 100.0f,
+            *EscapeCsv( report.MaxOverlapOwner ),
+            CountIssues( report.Issues, EPLSValidationSeverity::Error ),
+            CountIssues( report.Issues, EPLSValidationSeverity::Warning ),
+            *EscapeCsv( join_issues( report.Issues ) ) ) );
+    }
+
+    for ( const auto & pair : LevelGroupIssues )
+    {
+        const auto issues = GetLevelGroupIssues( pair.Key );
+
+        lines.Add( FString::Printf( TEXT( "%s,,,,,,%i,%i,%s" ),
+            *EscapeCsv( pair.Key ),
+            CountIssues( issues, EPLSValidationSeverity::Error ),
+            CountIssues( issues, EPLSValidationSeverity::Warning ),
+            *EscapeCsv( join_issues( issues ) ) ) );
+    }
+
+    return FFileHelper::SaveStringArrayToFile( lines, *file_path );
+}
+
+int32 FPLSConfigValidator::GetErrorCount() const
+{
+    auto count = 0;
+
+    for ( const auto & report : Reports )
+    {
+        count += CountIssues( report.Issues, EPLSValidationSeverity::Error );
+    }
+
+    for ( const auto & pair : LevelGroupIssues )
+    {
+        count += CountIssues( GetLevelGroupIssues( pair.Key ), EPLSValidationSeverity::Error );
+    }
+
+    return count;
+}
+
+int32 FPLSConfigValidator::GetWarningCount() const
+{
+    auto count = 0;
+
+    for ( const auto & report : Reports )
+    {
+        count += CountIssues( report.Issues, EPLSValidationSeverity::Warning );
+    }
+
+    for ( const auto & pair : LevelGroupIssues )
+    {
+        count += CountIssues( GetLevelGroupIssues( pair.Key ), EPLSValidationSeverity::Warning );
+    }
+
+    return count;
+}
+
+TArray< FPLSValidationIssue > FPLSConfigValidator::GetLevelGroupIssues( const FString & group_name ) const
+{
+    auto issues = LevelGroupIssues.FindRef( group_name );
+
+    if ( const auto * shared_level_issues = SharedLevelIssues.Find( group_name ) )
+    {
+        issues.Append( *shared_level_issues );
+    }
+
+    return issues;
+}
+
+void FPLSConfigValidator::ValidateLevelGroup( const UPLSLevelGroup & level_group, TArray< FPLSValidationIssue > & issues )
+{
+    TSet< FName > group_levels;
+
+    for ( const auto & level_path : level_group.Levels )
+    {
+        if ( level_path.IsNull() )
+        {
+            issues.Add( { EPLSValidationSeverity::Error, TEXT( "Empty level reference" ) } );
+            continue;
+        }
+
+        const auto package_name = level_path.GetLongPackageFName();
+
+        if ( !DoesLevelExist( package_name ) )
+        {
+            issues.Add( { EPLSValidationSeverity::Error, FString::Printf( TEXT( "Level %s does not exist" ), *package_name.ToString() ) } );
+        }
+
+        auto is_already_in_group = false;
+        group_levels.Add( package_name, &is_already_in_group );
+
+        if ( is_already_in_group )
+        {
+            issues.Add( { EPLSValidationSeverity::Warning, FString::Printf( TEXT( "Level %s is listed more than once" ), *package_name.ToString() ) } );
+        }
+    }
+
+    for ( const auto * dependency : level_group.Dependencies )
+    {
+        if ( dependency == nullptr )
+        {
+            issues.Add( { EPLSValidationSeverity::Error, TEXT( "Empty dependency" ) } );
+        }
+        else if ( dependency == &level_group )
+        {
+            issues.Add( { EPLSValidationSeverity::Error, TEXT( "The group depends on itself" ) } );
+        }
+    }
+
+    // The request loads each group once and ignores the cycles, so the groups of a cycle can not wait for each other
+    TSet< const UPLSLevelGroup * > visited_groups;
+    TArray< const UPLSLevelGroup * > dependency_chain;
+
+    TFunction< bool( const UPLSLevelGroup & ) > leads_back_to_group = [ & ]( const UPLSLevelGroup & group ) {
+        for ( const auto * dependency : group.Dependencies )
+        {
+            if ( dependency == &level_group )
+            {
+                return true;
+            }
+
+            if ( dependency == nullptr || visited_groups.Contains( dependency ) )
+            {
+                continue;
+            }
+
+            visited_groups.Add( dependency );
+            dependency_chain.Push( dependency );
+
+            if ( leads_back_to_group( *dependency ) )
+            {
+                return true;
+            }
+
+            dependency_chain.Pop();
+        }
+
+        return false;
+    };
+
+    for ( const auto * dependency : level_group.Dependencies )
+    {
+        // The direct dependency on itself is reported above
+        if ( dependency == nullptr || dependency == &level_group || visited_groups.Contains( dependency ) )
+        {
+            continue;
+        }
+
+        visited_groups.Add( dependency );
+        dependency_chain.Reset();
+        dependency_chain.Add( dependency );
+
+        if ( leads_back_to_group( *dependency ) )
+        {
+            const auto chain = FString::JoinBy( dependency_chain, TEXT( " -> " ), []( const auto * group ) {
+                return group->GetName();
+            } );
+
+            issues.Add( { EPLSValidationSeverity::Error, FString::Printf( TEXT( "The group is part of a dependency cycle : %s -> %s -> %s" ), *level_group.GetName(), *chain, *level_group.GetName() ) } );
+            break;
+        }
+    }
+
+    for ( const auto & level_dependency : level_group.LevelDependencies )
+    {
+        const auto package_name = level_dependency.Level.GetLongPackageFName();
+
+        if ( !group_levels.Contains( package_name ) )
+        {
+            issues.Add( { EPLSValidationSeverity::Error, FString::Printf( TEXT( "Level dependency on %s which is not in the group" ), *package_name.ToString() ) } );
+            continue;
+        }
+
+        for ( const auto & prerequisite : level_dependency.Prerequisites )
+        {
+            const auto prerequisite_package_name = prerequisite.GetLongPackageFName();
+
+            if ( prerequisite_package_name == package_name )
+            {
+                issues.Add( { EPLSValidationSeverity::Error, FString::Printf( TEXT( "Level %s depends on itself" ), *package_name.ToString() ) } );
+            }
+            else if ( !group_levels.Contains( prerequisite_package_name ) )
+            {
+                issues.Add( { EPLSValidationSeverity::Error, FString::Printf( TEXT( "Prerequisite %s of %s is not in the group" ), *prerequisite_package_name.ToString(), *package_name.ToString() ) } );
+            }
+        }
+    }
+}
+
+bool FPLSConfigValidator::DoesLevelExist( const FName package_name, int64 * size_on_disk )
+{
+    FString file_name;
+    if ( !FPackageName::DoesPackageExist( package_name.ToString(), &file_name ) )
+    {
+        return false;
+    }
+
+    if ( size_on_disk != nullptr )
+    {
+        *size_on_disk = FMath::Max< int64 >( 0, IFileManager::Get().FileSize( *file_name ) );
+    }
+
+    return true;
+}
+
+#endif
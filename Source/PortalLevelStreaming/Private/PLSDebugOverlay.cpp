@@ -0,0 +1,181 @@
+#include "PLSDebugOverlay.h"
+
+#include "PLSRequest.h"
+#include "PLSSubsystem.h"
+
+#include <Debug/DebugDrawService.h>
+#include <Engine/Canvas.h>
+#include <Engine/Engine.h>
+#include <GameFramework/PlayerController.h>
+#include <HAL/IConsoleManager.h>
+
+namespace
+{
+    TAutoConsoleVariable< bool > CVarShowDebugOverlay(
+        TEXT( "PLS.Debug.Overlay" ),
+        false,
+        TEXT( "Draws the portal level streaming requests, and the status of the levels of the executing request, on top of the game viewport" ) );
+
+    const TCHAR * GetLevelStatusText( const EPLSLevelRequestStatus status )
+    {
+        switch ( status )
+        {
+            case EPLSLevelRequestStatus::Queued:
+            {
+                return TEXT( "Queued" );
+            }
+            case EPLSLevelRequestStatus::WaitingForPrerequisites:
+            {
+                return TEXT( "Waiting for prerequisites" );
+            }
+            case EPLSLevelRequestStatus::WaitingForBudget:
+            {
+                return TEXT( "Waiting for budget" );
+            }
+            case EPLSLevelRequestStatus::Streaming:
+            {
+                return TEXT( "Streaming" );
+            }
+            case EPLSLevelRequestStatus::Done:
+            {
+                return TEXT( "Done" );
+            }
+            default:
+            {
+                checkNoEntry();
+            }
+            break;
+        }
+
+        return TEXT( "" );
+    }
+
+    FColor GetLevelStatusColor( const EPLSLevelRequestStatus status )
+    {
+        switch ( status )
+        {
+            case EPLSLevelRequestStatus::Streaming:
+            {
+                return FColor::Yellow;
+            }
+            case EPLSLevelRequestStatus::Done:
+            {
+                return FColor::Green;
+            }
+            default:
+            {
+                return FColor::Silver;
+            }
+        }
+    }
+}
+
+FPLSDebugOverlay::FPLSDebugOverlay( UPLSSubsystem & subsystem ) :
+    Subsystem( &subsystem )
+{
+    DrawDelegateHandle = UDebugDrawService::Register( TEXT( "Game" ), FDebugDrawDelegate::CreateRaw( this, &FPLSDebugOverlay::Draw ) );
+}
+
+FPLSDebugOverlay::~FPLSDebugOverlay()
+{
+    UDebugDrawService::Unregister( DrawDelegateHandle );
+}
+
+void FPLSDebugOverlay::GetDebugLines( const UPLSSubsystem & subsystem, TArray< FPLSDebugLine > & lines )
+{
+    const auto backend = subsystem.GetBackend();
+    const auto & requests = subsystem.GetRequests();
+    const auto & throttle = subsystem.GetThrottle();
+    const auto time = backend.IsValid() ? backend->GetTimeSeconds() : 0.0;
+
+    const auto max_transitions_per_tick = throttle.GetMaxTransitionsPerTick();
+
+    lines.Add( { FString::Printf( TEXT( "Portal level streaming : %i requests - %s transitions per tick - %.1f ms average frame - %i pending loads" ),
+                     requests.Num(),
+                     max_transitions_per_tick == MAX_int32 ? TEXT( "unlimited" ) : *FString::FromInt( max_transitions_per_tick ),
+                     throttle.GetAverageFrameTime() * 1000.0f,
+                     backend.IsValid() ? backend->GetPendingLoadCount() : 0 ),
+        FColor::White,
+        false } );
+
+    for ( auto index = 0; index < requests.Num(); ++index )
+    {
+        const auto * request = requests[ index ];
+
+        if ( index > 0 || !request->IsExecuting() )
+        {
+            lines.Add( { FString::Printf( TEXT( "  Request %s : queued - %i levels to unload, %i levels to load" ),
+                             *request->GetHandle().ToString(),
+                             request->GetLevelsToUnload().Num(),
+                             request->GetLevelsToLoad().Num() ),
+                FColor::Silver,
+                false } );
+            continue;
+        }
+
+        lines.Add( { FString::Printf( TEXT( "  Request %s : executing for %.1fs - %s - %i levels left to unload, %i levels left to load" ),
+                         *request->GetHandle().ToString(),
+                         time - request->GetProcessStartTime(),
+                         request->GetLoadOrder() == EPLSLoadOrder::LoadThenUnload ? TEXT( "load then unload" ) : TEXT( "unload then load" ),
+                         request->GetLevelToUnloadCount(),
+                         request->GetLevelToLoadCount() ),
+            FColor::Cyan,
+            false } );
+
+        const auto add_level_line = [ &lines, &backend, request, time ]( const FName level, const TCHAR * transition, const auto & infos ) {
+            const auto status = request->GetLevelStatus( level );
+
+            auto text = FString::Printf( TEXT( "    %s %s : %s" ), transition, *level.ToString(), GetLevelStatusText( status ) );
+
+            if ( status == EPLSLevelRequestStatus::Streaming )
+            {
+                text += FString::Printf( TEXT( " for %.1fs%s" ), time - infos.RequestTime, infos.bIsStuck ? TEXT( " - STUCK" ) : TEXT( "" ) );
+            }
+
+            text += FString::Printf( TEXT( " (loaded : %s, visible : %s)" ),
+                backend->IsLevelLoaded( level ) ? TEXT( "yes" ) : TEXT( "no" ),
+                backend->IsLevelVisible( level ) ? TEXT( "yes" ) : TEXT( "no" ) );
+
+            lines.Add( { MoveTemp( text ), infos.bIsStuck ? FColor::Red : GetLevelStatusColor( status ), static_cast< bool >( infos.bIsStuck ) } );
+        };
+
+        for ( const auto & pair : request->GetLevelsToUnload() )
+        {
+            add_level_line( pair.Key, pair.Value.UnloadType == EPLSLevelStreamingUnloadType::HideAndUnload ? TEXT( "Unload" ) : TEXT( "Hide" ), pair.Value );
+        }
+
+        for ( const auto & pair : request->GetLevelsToLoad() )
+        {
+            add_level_line( pair.Key, pair.Value.LoadType == EPLSLevelStreamingLoadType::LoadAndMakeVisible ? TEXT( "Show" ) : TEXT( "Load" ), pair.Value );
+        }
+    }
+}
+
+void FPLSDebugOverlay::Draw( UCanvas * canvas, APlayerController * player_controller )
+{
+    const auto * subsystem = Subsystem.Get();
+
+    if ( !CVarShowDebugOverlay.GetValueOnGameThread() || subsystem == nullptr || canvas == nullptr )
+    {
+        return;
+    }
+
+    // The debug draw service is shared by all the worlds, as with PIE clients
+    if ( player_controller == nullptr || player_controller->GetWorld() != subsystem->GetWorld() )
+    {
+        return;
+    }
+
+    TArray< FPLSDebugLine > lines;
+    GetDebugLines( *subsystem, lines );
+
+    const auto * font = GEngine->GetSmallFont();
+    const auto x = 50.0f;
+    auto y = 50.0f;
+
+    for ( const auto & line : lines )
+    {
+        canvas->SetDrawColor( line.Color );
+        y += canvas->DrawText( font, line.Text, x, y );
+    }
+}
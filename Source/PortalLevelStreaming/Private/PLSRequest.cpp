@@ -1,30 +1,40 @@
 #include "PLSRequest.h"
 
-#include <Engine/LevelStreaming.h>
+#include "PLSSubsystem.h"
+#include "PLSTrace.h"
+#include "PortalLevelStreaming.h"
 
-void UPLSRequest::Initialize( const FPLSLevelStreamingInfos & infos, const FPLSOnRequestExecutedDelegate & on_request_executed )
+#include <Algo/AnyOf.h>
+
+void UPLSRequest::Initialize( const FPLSLevelStreamingInfos & infos, const TSharedRef< IPLSStreamingBackend > & backend, const FPLSOnRequestExecutedDelegate & on_request_executed )
 {
-    LevelToLoadCount = 0.0f;
-    LevelToUnloadCount = 0.0f;
+    LevelToLoadCount = 0;
+    LevelToUnloadCount = 0;
+    LevelWaitingForPrerequisitesCount = 0;
+    TransitionBudget = MAX_int32;
+    bForceBlockingTransitions = false;
+    ProcessStartTime = 0.0;
     LoadOrder = infos.LoadOrder;
     Handle.GenerateNewHandle();
     OnRequestExecutedDelegate = on_request_executed;
+    Backend = backend;
 
-    const auto & streaming_levels = GetWorld()->GetStreamingLevels();
-
-    const auto add_level_to_unload = [ this, &infos ]( ULevelStreaming * level_streaming, const auto & params ) {
-        if ( level_streaming->ShouldBeAlwaysLoaded() && infos.AlwaysLoadedLevelsUnloadType == EPLSLevelStreamingAlwaysLoadedLevelsUnloadType::Nothing )
+    const auto add_level_to_unload = [ this, &infos ]( const FName level, const auto & params ) {
+        if ( Backend->IsLevelAlwaysLoaded( level ) && infos.AlwaysLoadedLevelsUnloadType == EPLSLevelStreamingAlwaysLoadedLevelsUnloadType::Nothing )
         {
             return;
         }
-        LevelsToUnloadMap.FindOrAdd( level_streaming, { params.bBlockOnUnload, params.UnloadType } );
+        LevelsToUnloadMap.FindOrAdd( level, { params.bBlockOnUnload, params.UnloadType } );
     };
 
     if ( infos.UnloadCurrentStreamingLevelsInfos.bUnloadCurrentlyLoadedStreamingLevels )
     {
-        for ( auto * level_streaming : streaming_levels )
+        TArray< FName > levels;
+        Backend->GetLevels( levels );
+
+        for ( const auto level : levels )
         {
-            add_level_to_unload( level_streaming, infos.UnloadCurrentStreamingLevelsInfos );
+            add_level_to_unload( level, infos.UnloadCurrentStreamingLevelsInfos );
         }
     }
     else
@@ -33,64 +43,149 @@ void UPLSRequest::Initialize( const FPLSLevelStreamingInfos & infos, const FPLSO
         {
             for ( auto * level_group : levels_to_unload.Levels.LevelGroups )
             {
+                if ( level_group == nullptr )
+                {
+                    continue;
+                }
+
                 for ( const auto & level_to_unload : level_group->Levels )
                 {
-                    if ( auto * level_streaming = FindLevelStreaming( level_to_unload ) )
+                    const auto level = Backend->FindLevel( level_to_unload );
+                    if ( !level.IsNone() )
                     {
-                        add_level_to_unload( level_streaming, levels_to_unload );
+                        add_level_to_unload( level, levels_to_unload );
                     }
                 }
             }
 
             for ( const auto & level_to_unload : levels_to_unload.Levels.IndividualLevels )
             {
-                if ( auto * level_streaming = FindLevelStreaming( level_to_unload ) )
+                const auto level = Backend->FindLevel( level_to_unload );
+                if ( !level.IsNone() )
+                {
+                    add_level_to_unload( level, levels_to_unload );
+                }
+            }
+
+            for ( const auto & level_instance : levels_to_unload.Levels.LevelInstances )
+            {
+                const auto level = Backend->FindLevelInstance( level_instance );
+                if ( !level.IsNone() )
                 {
-                    add_level_to_unload( level_streaming, levels_to_unload );
+                    add_level_to_unload( level, levels_to_unload );
                 }
             }
         }
     }
 
+    TMap< const UPLSLevelGroup *, TArray< FName > > loaded_groups;
+    TArray< TPair< const UPLSLevelGroup *, const FPLSLevelStreamingLevelToLoadInfos * > > groups_to_visit;
+
     for ( const auto & levels_to_load : infos.LevelsToLoad )
     {
-        const auto add_level_to_load = [ &levels_to_load, this ]( ULevelStreaming * level_streaming ) {
-            LevelsToLoadMap.FindOrAdd( level_streaming, { levels_to_load.bBlockOnLoad, levels_to_load.LoadType } );
-            LevelsToUnloadMap.Remove( level_streaming );
+        const auto add_level_to_load = [ &levels_to_load, this ]( const FName level ) {
+            LevelsToLoadMap.FindOrAdd( level, { levels_to_load.bBlockOnLoad, levels_to_load.LoadType } );
+            LevelsToUnloadMap.Remove( level );
         };
 
         for ( auto * level_group : levels_to_load.Levels.LevelGroups )
         {
-            for ( const auto & level_to_unload : level_group->Levels )
+            if ( level_group == nullptr )
+            {
+                continue;
+            }
+
+            AddLevelGroupToLoad( level_group, levels_to_load, loaded_groups );
+            groups_to_visit.Emplace( level_group, &levels_to_load );
+        }
+
+        for ( const auto & level_to_load : levels_to_load.Levels.IndividualLevels )
+        {
+            const auto level = Backend->FindLevel( level_to_load );
+            if ( !level.IsNone() )
+            {
+                add_level_to_load( level );
+            }
+        }
+
+        for ( const auto & level_instance : levels_to_load.Levels.LevelInstances )
+        {
+            const auto level = Backend->AcquireLevelInstance( level_instance );
+            if ( !level.IsNone() )
+            {
+                AcquiredLevelInstances.Add( level );
+                add_level_to_load( level );
+            }
+        }
+    }
+
+    // The group dependencies are added after the levels listed by the request, so those keep their own load parameters
+    for ( auto index = 0; index < groups_to_visit.Num(); ++index )
+    {
+        const auto [ level_group, levels_to_load ] = groups_to_visit[ index ];
+
+        for ( const auto * dependency : level_group->Dependencies )
+        {
+            if ( dependency != nullptr && !loaded_groups.Contains( dependency ) )
             {
-                if ( auto * level_streaming = FindLevelStreaming( level_to_unload ) )
+                AddLevelGroupToLoad( dependency, *levels_to_load, loaded_groups );
+                groups_to_visit.Emplace( dependency, levels_to_load );
+            }
+        }
+    }
+
+    for ( const auto & pair : loaded_groups )
+    {
+        for ( const auto * dependency : pair.Key->Dependencies )
+        {
+            if ( const auto * dependency_levels = loaded_groups.Find( dependency ) )
+            {
+                for ( const auto level : pair.Value )
                 {
-                    add_level_to_load( level_streaming );
+                    for ( const auto prerequisite : *dependency_levels )
+                    {
+                        AddLoadPrerequisite( level, prerequisite );
+                    }
                 }
             }
         }
 
-        for ( const auto & level_to_unload : levels_to_load.Levels.IndividualLevels )
+        for ( const auto & level_dependency : pair.Key->LevelDependencies )
         {
-            if ( auto * level_streaming = FindLevelStreaming( level_to_unload ) )
+            const auto level = Backend->FindLevel( level_dependency.Level );
+
+            for ( const auto & prerequisite : level_dependency.Prerequisites )
             {
-                add_level_to_load( level_streaming );
+                AddLoadPrerequisite( level, Backend->FindLevel( prerequisite ) );
             }
         }
     }
+
+    RemoveLoadPrerequisiteCycles();
 }
 
 void UPLSRequest::Cancel()
 {
+    // The backend only pools the instances which no other request holds, and which are not loaded or being loaded by this one
+    ReleaseAcquiredLevelInstances();
     UnbindLevelStreamingEvents();
     LevelsToUnloadMap.Reset();
     LevelsToLoadMap.Reset();
+    LevelsWaitingForBudget.Reset();
     LevelToUnloadCount = 0;
     LevelToLoadCount = 0;
+    LevelWaitingForPrerequisitesCount = 0;
 }
 
 void UPLSRequest::Process()
 {
+    if ( !LevelStateChangedHandle.IsValid() )
+    {
+        LevelStateChangedHandle = Backend->OnLevelStateChanged().AddUObject( this, &ThisClass::OnLevelStateChanged );
+    }
+
+    ProcessStartTime = Backend->GetTimeSeconds();
+
     switch ( LoadOrder )
     {
         case EPLSLoadOrder::LoadThenUnload:
@@ -126,55 +221,114 @@ UWorld * UPLSRequest::GetWorld() const
     return nullptr;
 }
 
-ULevelStreaming * UPLSRequest::FindLevelStreaming( const FSoftObjectPath & soft_object_path ) const
+EPLSLevelRequestStatus UPLSRequest::GetLevelStatus( const FName level ) const
 {
-    const auto level_name = FName( *FPackageName::ObjectPathToPackageName( soft_object_path.ToString() ) );
-    const auto safe_level_name = FStreamLevelAction::MakeSafeLevelName( level_name, GetWorld() );
-    const auto & streaming_levels = GetWorld()->GetStreamingLevels();
+    if ( const auto * infos = LevelsToUnloadMap.Find( level ) )
+    {
+        if ( infos->bIsPending )
+        {
+            return EPLSLevelRequestStatus::Streaming;
+        }
+
+        if ( LevelsWaitingForBudget.Contains( level ) )
+        {
+            return EPLSLevelRequestStatus::WaitingForBudget;
+        }
 
-    for ( auto * level_streaming : streaming_levels )
+        return HasReachedUnloadedState( level, *infos ) ? EPLSLevelRequestStatus::Done : EPLSLevelRequestStatus::Queued;
+    }
+
+    if ( const auto * infos = LevelsToLoadMap.Find( level ) )
     {
-        if ( level_streaming != nullptr && level_streaming->GetWorldAssetPackageName().EndsWith( safe_level_name, ESearchCase::IgnoreCase ) )
+        if ( infos->bIsPending )
+        {
+            return EPLSLevelRequestStatus::Streaming;
+        }
+
+        if ( infos->bIsWaitingForPrerequisites )
         {
-            return level_streaming;
+            return EPLSLevelRequestStatus::WaitingForPrerequisites;
         }
+
+        if ( LevelsWaitingForBudget.Contains( level ) )
+        {
+            return EPLSLevelRequestStatus::WaitingForBudget;
+        }
+
+        return HasReachedLoadedState( level, *infos ) ? EPLSLevelRequestStatus::Done : EPLSLevelRequestStatus::Queued;
     }
 
-    return nullptr;
+    return EPLSLevelRequestStatus::Done;
 }
 
-void UPLSRequest::UnloadLevels( const bool load_levels_when_finished )
+void UPLSRequest::SkipPendingLevels()
 {
-    for ( const auto & pair : LevelsToUnloadMap )
+    if ( LevelToUnloadCount > 0 )
+    {
+        UE_LOG( LogPLS, Warning, TEXT( "Request %s : skipping the %i levels still to unload" ), *Handle.ToString(), LevelToUnloadCount );
+
+        LevelsWaitingForBudget.Reset();
+        LevelToUnloadCount = 0;
+        FinishUnloadStep();
+    }
+    else if ( LevelToLoadCount > 0 )
     {
-        auto * level_streaming = pair.Key;
-        const auto should_be_unloaded = pair.Value.UnloadType == EPLSLevelStreamingUnloadType::HideAndUnload;
+        UE_LOG( LogPLS, Warning, TEXT( "Request %s : skipping the %i levels still to load" ), *Handle.ToString(), LevelToLoadCount );
+
+        LevelsWaitingForBudget.Reset();
+        LevelWaitingForPrerequisitesCount = 0;
+        LevelToLoadCount = 0;
+        FinishLoadStep();
+    }
+}
 
-        if ( should_be_unloaded && !level_streaming->IsLevelLoaded() || pair.Value.UnloadType == EPLSLevelStreamingUnloadType::Hide && !level_streaming->IsLevelVisible() )
+void UPLSRequest::ReportStuckLevels( const double timeout )
+{
+    const auto time = Backend->GetTimeSeconds();
+
+    const auto report_stuck_level = [ this, time, timeout ]( const FName level, auto & infos, const TCHAR * requested_state ) {
+        if ( !infos.bIsPending || infos.bIsStuck || time - infos.RequestTime < timeout )
         {
-            continue;
+            return;
         }
 
-        level_streaming->SetShouldBeLoaded( !should_be_unloaded );
-        level_streaming->SetShouldBeVisible( false );
-        level_streaming->bShouldBlockOnUnload = pair.Value.bBlockOnUnload;
+        infos.bIsStuck = true;
+
+        UE_LOG( LogPLS,
+            Warning,
+            TEXT( "Request %s has been waiting %.1fs for level %s to be %s (loaded : %s, visible : %s). Use PLS.Requests.Force to skip it" ),
+            *Handle.ToString(),
+            time - infos.RequestTime,
+            *level.ToString(),
+            requested_state,
+            Backend->IsLevelLoaded( level ) ? TEXT( "yes" ) : TEXT( "no" ),
+            Backend->IsLevelVisible( level ) ? TEXT( "yes" ) : TEXT( "no" ) );
+    };
+
+    for ( auto & pair : LevelsToUnloadMap )
+    {
+        report_stuck_level( pair.Key, pair.Value, pair.Value.UnloadType == EPLSLevelStreamingUnloadType::HideAndUnload ? TEXT( "unloaded" ) : TEXT( "hidden" ) );
+    }
+
+    for ( auto & pair : LevelsToLoadMap )
+    {
+        report_stuck_level( pair.Key, pair.Value, pair.Value.LoadType == EPLSLevelStreamingLoadType::LoadAndMakeVisible ? TEXT( "shown" ) : TEXT( "loaded" ) );
+    }
+}
 
-        for ( auto iterator = GetWorld()->GetPlayerControllerIterator(); iterator; ++iterator )
+void UPLSRequest::UnloadLevels( const bool load_levels_when_finished )
+{
+    for ( auto & pair : LevelsToUnloadMap )
+    {
+        const auto level = pair.Key;
+
+        if ( HasReachedUnloadedState( level, pair.Value ) )
         {
-            if ( auto * player_controller = iterator->Get() )
-            {
-                player_controller->LevelStreamingStatusChanged(
-                    level_streaming,
-                    !should_be_unloaded,
-                    false,
-                    pair.Value.bBlockOnUnload,
-                    INDEX_NONE );
-            }
+            continue;
         }
 
         LevelToUnloadCount++;
-
-        level_streaming->OnLevelHidden.AddDynamic( this, &UPLSRequest::OnLevelStreamingUnloaded );
+        UnloadLevel( level, pair.Value );
     }
 
     if ( LevelToUnloadCount == 0 )
@@ -192,102 +346,423 @@ void UPLSRequest::UnloadLevels( const bool load_levels_when_finished )
 
 void UPLSRequest::LoadLevels( const bool unload_levels_when_finished )
 {
-    for ( const auto & pair : LevelsToLoadMap )
+    for ( auto & pair : LevelsToLoadMap )
     {
-        auto * level_streaming = pair.Key;
+        const auto level = pair.Key;
 
-        if ( level_streaming->IsLevelVisible() && pair.Value.LoadType == EPLSLevelStreamingLoadType::LoadAndMakeVisible )
+        if ( HasReachedLoadedState( level, pair.Value ) )
         {
             continue;
         }
 
-        if ( level_streaming->IsLevelLoaded() && pair.Value.LoadType == EPLSLevelStreamingLoadType::Load )
+        LevelToLoadCount++;
+
+        if ( !ArePrerequisitesLoaded( pair.Value ) )
         {
+            pair.Value.bIsWaitingForPrerequisites = true;
+            LevelWaitingForPrerequisitesCount++;
             continue;
         }
 
-        const auto make_visible = pair.Value.LoadType == EPLSLevelStreamingLoadType::LoadAndMakeVisible;
+        LoadLevel( level, pair.Value );
+    }
+
+    if ( LevelToLoadCount == 0 )
+    {
+        if ( unload_levels_when_finished )
+        {
+            UnloadLevels( false );
+        }
+        else
+        {
+            BroadcastExecutedEvent();
+        }
+    }
+}
+
+bool UPLSRequest::HasReachedUnloadedState( const FName level, const FUnloadLevelInfos & infos ) const
+{
+    switch ( infos.UnloadType )
+    {
+        case EPLSLevelStreamingUnloadType::Hide:
+        {
+            return !Backend->IsLevelVisible( level );
+        }
+        case EPLSLevelStreamingUnloadType::HideAndUnload:
+        {
+            return !Backend->IsLevelLoaded( level );
+        }
+        default:
+        {
+            checkNoEntry();
+        }
+        break;
+    }
+
+    return true;
+}
+
+bool UPLSRequest::HasReachedLoadedState( const FName level, const FLoadLevelInfos & infos ) const
+{
+    switch ( infos.LoadType )
+    {
+        case EPLSLevelStreamingLoadType::Load:
+        {
+            return Backend->IsLevelLoaded( level );
+        }
+        case EPLSLevelStreamingLoadType::LoadAndMakeVisible:
+        {
+            return Backend->IsLevelVisible( level );
+        }
+        default:
+        {
+            checkNoEntry();
+        }
+        break;
+    }
+
+    return true;
+}
+
+void UPLSRequest::AddLevelGroupToLoad( const UPLSLevelGroup * level_group, const FPLSLevelStreamingLevelToLoadInfos & levels_to_load, TMap< const UPLSLevelGroup *, TArray< FName > > & loaded_groups )
+{
+    if ( level_group == nullptr || loaded_groups.Contains( level_group ) )
+    {
+        return;
+    }
+
+    auto & group_levels = loaded_groups.Add( level_group );
+
+    for ( const auto & level_to_load : level_group->Levels )
+    {
+        const auto level = Backend->FindLevel( level_to_load );
+        if ( !level.IsNone() )
+        {
+            LevelsToLoadMap.FindOrAdd( level, { levels_to_load.bBlockOnLoad, levels_to_load.LoadType } );
+            LevelsToUnloadMap.Remove( level );
+            group_levels.Add( level );
+        }
+    }
+}
+
+void UPLSRequest::AddLoadPrerequisite( const FName level, const FName prerequisite )
+{
+    if ( level.IsNone() || prerequisite.IsNone() || level == prerequisite || !LevelsToLoadMap.Contains( prerequisite ) )
+    {
+        return;
+    }
+
+    if ( auto * infos = LevelsToLoadMap.Find( level ) )
+    {
+        infos->Prerequisites.AddUnique( prerequisite );
+    }
+}
+
+void UPLSRequest::RemoveLoadPrerequisiteCycles()
+{
+    const auto has_prerequisites = Algo::AnyOf( LevelsToLoadMap, []( const auto & pair ) {
+        return !pair.Value.Prerequisites.IsEmpty();
+    } );
 
-        level_streaming->SetShouldBeLoaded( true );
-        level_streaming->SetShouldBeVisible( make_visible );
-        level_streaming->bShouldBlockOnLoad = pair.Value.bBlockOnLoad;
+    if ( !has_prerequisites )
+    {
+        return;
+    }
 
-        for ( auto iterator = GetWorld()->GetPlayerControllerIterator(); iterator; ++iterator )
+    // Tarjan's algorithm : the levels of a cycle end up in the same strongly connected component.
+    // Only the prerequisites inside a component are removed, so the levels which depend on a cycle still wait for it
+    TMap< FName, int32 > indices;
+    TMap< FName, int32 > low_links;
+    TMap< FName, int32 > components;
+    TArray< FName > stack;
+    TSet< FName > stacked_levels;
+    auto next_index = 0;
+    auto component_count = 0;
+
+    TFunction< void( FName ) > connect_level = [ & ]( const FName level ) {
+        indices.Add( level, next_index );
+        low_links.Add( level, next_index );
+        next_index++;
+        stack.Push( level );
+        stacked_levels.Add( level );
+
+        for ( const auto prerequisite : LevelsToLoadMap.FindChecked( level ).Prerequisites )
         {
-            if ( auto * player_controller = iterator->Get() )
+            if ( !indices.Contains( prerequisite ) )
+            {
+                connect_level( prerequisite );
+                low_links.FindChecked( level ) = FMath::Min( low_links.FindChecked( level ), low_links.FindChecked( prerequisite ) );
+            }
+            else if ( stacked_levels.Contains( prerequisite ) )
             {
-                player_controller->LevelStreamingStatusChanged(
-                    level_streaming,
-                    true,
-                    make_visible,
-                    pair.Value.bBlockOnLoad,
-                    INDEX_NONE );
+                low_links.FindChecked( level ) = FMath::Min( low_links.FindChecked( level ), indices.FindChecked( prerequisite ) );
             }
         }
 
-        LevelToLoadCount++;
+        if ( low_links.FindChecked( level ) == indices.FindChecked( level ) )
+        {
+            FName component_level;
+            do
+            {
+                component_level = stack.Pop();
+                stacked_levels.Remove( component_level );
+                components.Add( component_level, component_count );
+            } while ( component_level != level );
+
+            component_count++;
+        }
+    };
 
-        if ( make_visible )
+    for ( const auto & pair : LevelsToLoadMap )
+    {
+        if ( !indices.Contains( pair.Key ) )
         {
-            level_streaming->OnLevelShown.AddDynamic( this, &ThisClass::OnLevelStreamingLoadedOrVisible );
+            connect_level( pair.Key );
         }
-        else
+    }
+
+    for ( auto & pair : LevelsToLoadMap )
+    {
+        const auto component = components.FindChecked( pair.Key );
+
+        const auto removed_count = pair.Value.Prerequisites.RemoveAll( [ &components, component ]( const FName prerequisite ) {
+            return components.FindChecked( prerequisite ) == component;
+        } );
+
+        if ( removed_count > 0 )
         {
-            level_streaming->OnLevelLoaded.AddDynamic( this, &ThisClass::OnLevelStreamingLoadedOrVisible );
+            UE_LOG( LogPLS, Error, TEXT( "Level %s is part of a dependency cycle. Its %i prerequisites inside the cycle are ignored" ), *pair.Key.ToString(), removed_count );
         }
     }
+}
 
-    if ( LevelToLoadCount == 0 )
+bool UPLSRequest::ArePrerequisitesLoaded( const FLoadLevelInfos & infos ) const
+{
+    for ( const auto prerequisite : infos.Prerequisites )
     {
-        if ( unload_levels_when_finished )
+        const auto * prerequisite_infos = LevelsToLoadMap.Find( prerequisite );
+        if ( prerequisite_infos != nullptr && !HasReachedLoadedState( prerequisite, *prerequisite_infos ) )
         {
-            UnloadLevels( false );
+            return false;
         }
-        else
+    }
+
+    return true;
+}
+
+void UPLSRequest::LoadLevel( const FName level, FLoadLevelInfos & infos )
+{
+    if ( !ConsumeTransitionBudget( level ) )
+    {
+        return;
+    }
+
+    const auto make_visible = infos.LoadType == EPLSLevelStreamingLoadType::LoadAndMakeVisible;
+
+    Backend->RequestLevelLoad( level, make_visible, infos.bBlockOnLoad || bForceBlockingTransitions );
+    RecordLevelRequested( level, true, make_visible );
+
+    infos.bIsPending = true;
+    infos.RequestTime = Backend->GetTimeSeconds();
+}
+
+void UPLSRequest::UnloadLevel( const FName level, FUnloadLevelInfos & infos )
+{
+    if ( !ConsumeTransitionBudget( level ) )
+    {
+        return;
+    }
+
+    const auto should_be_unloaded = infos.UnloadType == EPLSLevelStreamingUnloadType::HideAndUnload;
+
+    Backend->RequestLevelUnload( level, should_be_unloaded, infos.bBlockOnUnload || bForceBlockingTransitions );
+    RecordLevelRequested( level, !should_be_unloaded, false );
+
+    infos.bIsPending = true;
+    infos.RequestTime = Backend->GetTimeSeconds();
+}
+
+bool UPLSRequest::ConsumeTransitionBudget( const FName level )
+{
+    if ( TransitionBudget <= 0 )
+    {
+        LevelsWaitingForBudget.Add( level );
+        return false;
+    }
+
+    TransitionBudget--;
+    return true;
+}
+
+void UPLSRequest::SetTransitionBudget( const int32 transition_budget, const bool force_blocking_transitions )
+{
+    TransitionBudget = transition_budget;
+    bForceBlockingTransitions = force_blocking_transitions;
+
+    if ( LevelsWaitingForBudget.IsEmpty() )
+    {
+        return;
+    }
+
+    // The levels which still do not fit in the budget are queued again, in the same order
+    const auto levels_waiting_for_budget = MoveTemp( LevelsWaitingForBudget );
+    LevelsWaitingForBudget.Reset();
+
+    for ( const auto level : levels_waiting_for_budget )
+    {
+        if ( LevelToUnloadCount > 0 )
         {
-            BroadcastExecutedEvent();
+            if ( auto * infos = LevelsToUnloadMap.Find( level ) )
+            {
+                if ( HasReachedUnloadedState( level, *infos ) )
+                {
+                    OnLevelUnloaded();
+                }
+                else
+                {
+                    UnloadLevel( level, *infos );
+                }
+            }
+        }
+        else if ( LevelToLoadCount > 0 )
+        {
+            if ( auto * infos = LevelsToLoadMap.Find( level ) )
+            {
+                if ( HasReachedLoadedState( level, *infos ) )
+                {
+                    OnLevelLoaded();
+                }
+                else
+                {
+                    LoadLevel( level, *infos );
+                }
+            }
         }
     }
 }
 
-void UPLSRequest::OnLevelStreamingUnloaded()
+void UPLSRequest::LoadLevelsWithLoadedPrerequisites()
+{
+    // Levels which are already loaded when their prerequisites complete can in turn free other levels
+    auto has_freed_levels = true;
+
+    while ( has_freed_levels && LevelWaitingForPrerequisitesCount > 0 )
+    {
+        has_freed_levels = false;
+
+        for ( auto & pair : LevelsToLoadMap )
+        {
+            if ( !pair.Value.bIsWaitingForPrerequisites || !ArePrerequisitesLoaded( pair.Value ) )
+            {
+                continue;
+            }
+
+            pair.Value.bIsWaitingForPrerequisites = false;
+            LevelWaitingForPrerequisitesCount--;
+
+            if ( HasReachedLoadedState( pair.Key, pair.Value ) )
+            {
+                LevelToLoadCount--;
+                has_freed_levels = true;
+                continue;
+            }
+
+            LoadLevel( pair.Key, pair.Value );
+        }
+    }
+}
+
+void UPLSRequest::ReleaseAcquiredLevelInstances()
+{
+    for ( const auto level : AcquiredLevelInstances )
+    {
+        Backend->ReleaseLevelInstance( level );
+    }
+    AcquiredLevelInstances.Reset();
+}
+
+void UPLSRequest::OnLevelStateChanged( const FName level )
+{
+    if ( LevelToUnloadCount > 0 )
+    {
+        auto * infos = LevelsToUnloadMap.Find( level );
+        if ( infos != nullptr && infos->bIsPending && HasReachedUnloadedState( level, *infos ) )
+        {
+            infos->bIsPending = false;
+            OnLevelUnloaded();
+        }
+    }
+    else if ( LevelToLoadCount > 0 )
+    {
+        auto * infos = LevelsToLoadMap.Find( level );
+        if ( infos != nullptr && infos->bIsPending && HasReachedLoadedState( level, *infos ) )
+        {
+            infos->bIsPending = false;
+            OnLevelLoaded();
+        }
+    }
+}
+
+void UPLSRequest::OnLevelUnloaded()
 {
     LevelToUnloadCount--;
 
-    // LevelToUnloadCount can become negative if active requests are cancelled
-    if ( LevelToUnloadCount <= 0 )
+    if ( LevelToUnloadCount == 0 )
     {
-        LevelsToUnloadMap.Reset();
-        LoadLevels( false );
+        FinishUnloadStep();
     }
 }
 
-void UPLSRequest::OnLevelStreamingLoadedOrVisible()
+void UPLSRequest::OnLevelLoaded()
 {
     LevelToLoadCount--;
 
-    // LevelToLoadCount can become negative if active requests are cancelled
-    if ( LevelToLoadCount <= 0 )
+    if ( LevelWaitingForPrerequisitesCount > 0 )
     {
-        LevelsToLoadMap.Reset();
-        UnloadLevels( false );
+        LoadLevelsWithLoadedPrerequisites();
     }
+
+    if ( LevelToLoadCount == 0 )
+    {
+        FinishLoadStep();
+    }
+}
+
+void UPLSRequest::FinishUnloadStep()
+{
+    LevelsToUnloadMap.Reset();
+    LoadLevels( false );
+}
+
+void UPLSRequest::FinishLoadStep()
+{
+    LevelsToLoadMap.Reset();
+    UnloadLevels( false );
 }
 
-void UPLSRequest::BroadcastExecutedEvent() const
+void UPLSRequest::RecordLevelRequested( const FName level, const bool should_be_loaded, const bool should_be_visible ) const
 {
+    if ( const auto * subsystem = GetTypedOuter< UPLSSubsystem >() )
+    {
+        if ( auto * trace_recorder = subsystem->GetTraceRecorder() )
+        {
+            trace_recorder->RecordLevelRequested( Handle, level, should_be_loaded, should_be_visible );
+        }
+    }
+}
+
+void UPLSRequest::BroadcastExecutedEvent()
+{
+    ReleaseAcquiredLevelInstances();
     UnbindLevelStreamingEvents();
     OnRequestExecutedDelegate.ExecuteIfBound( Handle );
 }
 
-void UPLSRequest::UnbindLevelStreamingEvents() const
+void UPLSRequest::UnbindLevelStreamingEvents()
 {
-    const auto & streaming_levels = GetWorld()->GetStreamingLevels();
-
-    for ( auto * level_streaming : streaming_levels )
+    if ( Backend.IsValid() )
     {
-        level_streaming->OnLevelShown.RemoveAll( this );
-        level_streaming->OnLevelHidden.RemoveAll( this );
-        level_streaming->OnLevelLoaded.RemoveAll( this );
+        Backend->OnLevelStateChanged().Remove( LevelStateChangedHandle );
     }
+    LevelStateChangedHandle.Reset();
 }
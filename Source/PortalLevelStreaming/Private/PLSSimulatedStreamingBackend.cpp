@@ -0,0 +1,304 @@
+#include "PLSSimulatedStreamingBackend.h"
+
+#include "PLSTypes.h"
+
+FPLSSimulatedStreamingBackend::FPLSSimulatedStreamingBackend( const int32 random_seed, const float latency_jitter ) :
+    RandomStream( random_seed ),
+    LatencyJitter( latency_jitter ),
+    Time( 0.0 ),
+    IOBusyUntilTime( 0.0 ),
+    BlockingTime( 0.0 ),
+    MemoryUsage( 0 ),
+    PeakMemoryUsage( 0 ),
+    MaxPooledLevelInstances( 8 ),
+    CreatedLevelInstanceCount( 0 )
+{
+}
+
+void FPLSSimulatedStreamingBackend::AddLevel( const FName level, const FPLSSimulatedLevelSettings & settings )
+{
+    auto & simulated_level = Levels.FindOrAdd( level );
+    simulated_level.Settings = settings;
+
+    if ( settings.bAlwaysLoaded )
+    {
+        simulated_level.bShouldBeLoaded = true;
+        simulated_level.bShouldBeVisible = true;
+        TransitioningLevels.Add( level );
+    }
+}
+
+void FPLSSimulatedStreamingBackend::SetMaxPooledLevelInstances( const int32 max_pooled_level_instances )
+{
+    MaxPooledLevelInstances = FMath::Max( 0, max_pooled_level_instances );
+}
+
+void FPLSSimulatedStreamingBackend::Tick( const double delta_seconds )
+{
+    Time += delta_seconds;
+
+    // Iterate over a copy : the level state changed callbacks can request new transitions
+    for ( const auto level_name : TransitioningLevels.Array() )
+    {
+        if ( !UpdateLevel( level_name ) )
+        {
+            TransitioningLevels.Remove( level_name );
+        }
+    }
+}
+
+FName FPLSSimulatedStreamingBackend::FindLevel( const FSoftObjectPath & soft_object_path ) const
+{
+    const auto level_name = FName( *FPackageName::ObjectPathToPackageName( soft_object_path.ToString() ) );
+    return Levels.Contains( level_name ) ? level_name : NAME_None;
+}
+
+void FPLSSimulatedStreamingBackend::GetLevels( TArray< FName > & levels ) const
+{
+    for ( const auto & pair : Levels )
+    {
+        levels.Add( pair.Key );
+    }
+}
+
+bool FPLSSimulatedStreamingBackend::IsLevelLoaded( const FName level ) const
+{
+    const auto * simulated_level = Levels.Find( level );
+    return simulated_level != nullptr && simulated_level->State != ELevelState::Unloaded && simulated_level->State != ELevelState::Loading;
+}
+
+bool FPLSSimulatedStreamingBackend::IsLevelVisible( const FName level ) const
+{
+    const auto * simulated_level = Levels.Find( level );
+    return simulated_level != nullptr && ( simulated_level->State == ELevelState::LoadedVisible || simulated_level->State == ELevelState::MakingInvisible );
+}
+
+bool FPLSSimulatedStreamingBackend::IsLevelAlwaysLoaded( const FName level ) const
+{
+    const auto * simulated_level = Levels.Find( level );
+    return simulated_level != nullptr && simulated_level->Settings.bAlwaysLoaded;
+}
+
+void FPLSSimulatedStreamingBackend::RequestLevelLoad( const FName level, const bool make_visible, const bool block_on_load )
+{
+    if ( auto * simulated_level = Levels.Find( level ) )
+    {
+        simulated_level->bShouldBeLoaded = true;
+        simulated_level->bShouldBeVisible = make_visible;
+        simulated_level->bShouldBlock = block_on_load;
+        TransitioningLevels.Add( level );
+    }
+}
+
+void FPLSSimulatedStreamingBackend::RequestLevelUnload( const FName level, const bool unload, const bool block_on_unload )
+{
+    if ( auto * simulated_level = Levels.Find( level ) )
+    {
+        simulated_level->bShouldBeLoaded = !unload;
+        simulated_level->bShouldBeVisible = false;
+        simulated_level->bShouldBlock = block_on_unload;
+        TransitioningLevels.Add( level );
+    }
+}
+
+double FPLSSimulatedStreamingBackend::GetTimeSeconds() const
+{
+    return Time;
+}
+
+int32 FPLSSimulatedStreamingBackend::GetPendingLoadCount() const
+{
+    auto pending_load_count = 0;
+
+    for ( const auto level_name : TransitioningLevels )
+    {
+        if ( Levels.FindChecked( level_name ).State == ELevelState::Loading )
+        {
+            pending_load_count++;
+        }
+    }
+
+    return pending_load_count;
+}
+
+FName FPLSSimulatedStreamingBackend::CreateLevelInstance( const FPLSLevelInstanceInfos & infos, const FName instance_name )
+{
+    // The instance costs as much as the level it instantiates, when the simulation knows it. Copied because adding the instance can reallocate Levels
+    const auto * source_level = Levels.Find( FindLevel( infos.Level.ToSoftObjectPath() ) );
+    const auto settings = source_level != nullptr ? source_level->Settings : FPLSSimulatedLevelSettings();
+
+    AddLevel( instance_name, settings );
+    CreatedLevelInstanceCount++;
+
+    return instance_name;
+}
+
+void FPLSSimulatedStreamingBackend::DestroyLevelInstance( const FName level )
+{
+    Levels.Remove( level );
+    TransitioningLevels.Remove( level );
+}
+
+bool FPLSSimulatedStreamingBackend::DoesLevelExist( const FName level ) const
+{
+    return Levels.Contains( level );
+}
+
+bool FPLSSimulatedStreamingBackend::ShouldLevelBeLoaded( const FName level ) const
+{
+    const auto * simulated_level = Levels.Find( level );
+    return simulated_level != nullptr && ( simulated_level->bShouldBeLoaded || simulated_level->State != ELevelState::Unloaded );
+}
+
+int32 FPLSSimulatedStreamingBackend::GetMaxPooledLevelInstances() const
+{
+    return MaxPooledLevelInstances;
+}
+
+bool FPLSSimulatedStreamingBackend::UpdateLevel( const FName level_name )
+{
+    for ( ;; )
+    {
+        // The state changed listeners can create, release or destroy levels, which invalidates any reference into Levels : look the level up again after each broadcast
+        auto * level = Levels.Find( level_name );
+        if ( level == nullptr )
+        {
+            return false;
+        }
+
+        switch ( AdvanceLevel( *level ) )
+        {
+            case EAdvanceResult::Transitioning:
+            {
+                return true;
+            }
+            case EAdvanceResult::Idle:
+            {
+                return false;
+            }
+            case EAdvanceResult::StateChanged:
+            {
+                BroadcastLevelStateChanged( level_name );
+            }
+            break;
+            case EAdvanceResult::TransitionStarted:
+            {
+            }
+            break;
+            default:
+            {
+                checkNoEntry();
+                return false;
+            }
+        }
+    }
+}
+
+FPLSSimulatedStreamingBackend::EAdvanceResult FPLSSimulatedStreamingBackend::AdvanceLevel( FLevel & level )
+{
+    // Blocking transitions complete during the current tick, and their latency is accounted as a hitch
+    const auto start_transition = [ this, &level ]( const ELevelState new_state, const double latency, const double start_time ) {
+        level.State = new_state;
+
+        if ( level.bShouldBlock )
+        {
+            BlockingTime += latency;
+            level.TransitionEndTime = Time;
+        }
+        else
+        {
+            level.TransitionEndTime = start_time + latency;
+        }
+
+        return EAdvanceResult::TransitionStarted;
+    };
+
+    switch ( level.State )
+    {
+        case ELevelState::Unloaded:
+        {
+            if ( !level.bShouldBeLoaded )
+            {
+                return EAdvanceResult::Idle;
+            }
+
+            start_transition( ELevelState::Loading, GetLatency( level.Settings.LoadLatency ), FMath::Max( Time, IOBusyUntilTime ) );
+            IOBusyUntilTime = FMath::Max( IOBusyUntilTime, level.TransitionEndTime );
+            return EAdvanceResult::TransitionStarted;
+        }
+        case ELevelState::Loading:
+        {
+            if ( Time < level.TransitionEndTime )
+            {
+                return EAdvanceResult::Transitioning;
+            }
+
+            level.State = ELevelState::LoadedNotVisible;
+            MemoryUsage += level.Settings.MemoryCost;
+            PeakMemoryUsage = FMath::Max( PeakMemoryUsage, MemoryUsage );
+            return EAdvanceResult::StateChanged;
+        }
+        case ELevelState::LoadedNotVisible:
+        {
+            if ( level.bShouldBeVisible )
+            {
+                return start_transition( ELevelState::MakingVisible, GetLatency( level.Settings.VisibilityLatency ), Time );
+            }
+
+            if ( !level.bShouldBeLoaded )
+            {
+                level.State = ELevelState::Unloaded;
+                MemoryUsage -= level.Settings.MemoryCost;
+                return EAdvanceResult::StateChanged;
+            }
+
+            return EAdvanceResult::Idle;
+        }
+        case ELevelState::MakingVisible:
+        {
+            if ( Time < level.TransitionEndTime )
+            {
+                return EAdvanceResult::Transitioning;
+            }
+
+            level.State = ELevelState::LoadedVisible;
+            return EAdvanceResult::StateChanged;
+        }
+        case ELevelState::LoadedVisible:
+        {
+            if ( level.bShouldBeVisible )
+            {
+                return EAdvanceResult::Idle;
+            }
+
+            return start_transition( ELevelState::MakingInvisible, GetLatency( level.Settings.VisibilityLatency ), Time );
+        }
+        case ELevelState::MakingInvisible:
+        {
+            if ( Time < level.TransitionEndTime )
+            {
+                return EAdvanceResult::Transitioning;
+            }
+
+            level.State = ELevelState::LoadedNotVisible;
+            return EAdvanceResult::StateChanged;
+        }
+        default:
+        {
+            checkNoEntry();
+        }
+        break;
+    }
+
+    return EAdvanceResult::Idle;
+}
+
+double FPLSSimulatedStreamingBackend::GetLatency( const double latency )
+{
+    if ( LatencyJitter <= 0.0f )
+    {
+        return latency;
+    }
+
+    return FMath::Max( 0.0, latency * ( 1.0 + RandomStream.FRandRange( -LatencyJitter, LatencyJitter ) ) );
+}
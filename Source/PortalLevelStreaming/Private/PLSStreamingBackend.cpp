@@ -0,0 +1,351 @@
+#include "PLSStreamingBackend.h"
+
+#include "PLSTypes.h"
+#include "PortalLevelStreaming.h"
+
+#include <Engine/LevelStreaming.h>
+#include <Engine/LevelStreamingDynamic.h>
+#include <Engine/World.h>
+#include <GameFramework/PlayerController.h>
+#include <HAL/IConsoleManager.h>
+#include <Streaming/LevelStreamingDelegates.h>
+#include <UObject/UObjectGlobals.h>
+#include <WorldPartition/WorldPartitionLevelStreamingDynamic.h>
+
+namespace
+{
+    TAutoConsoleVariable< int32 > CVarMaxPooledLevelInstances(
+        TEXT( "PLS.LevelInstances.MaxPooled" ),
+        8,
+        TEXT( "Number of unloaded level instances kept alive to be reused by the next requests, before they are removed from the world" ) );
+}
+
+FName IPLSStreamingBackend::AcquireLevelInstance( const FPLSLevelInstanceInfos & infos )
+{
+    const auto instance_name = infos.GetInstanceName();
+
+    if ( const auto * existing_level = InstanceNameToLevelMap.Find( instance_name ) )
+    {
+        const auto level = *existing_level;
+        auto & level_instance = LevelInstances.FindChecked( level );
+
+        if ( level_instance.SourceLevel != infos.Level.ToSoftObjectPath() )
+        {
+            UE_LOG( LogPLS, Error, TEXT( "The level instance %s of %s can not be used for %s : give them different instance names" ), *instance_name.ToString(), *level_instance.SourceLevel.ToString(), *infos.Level.ToString() );
+            return NAME_None;
+        }
+
+        if ( DoesLevelExist( level ) )
+        {
+            level_instance.AcquireCount++;
+            PooledLevelInstances.Remove( level );
+            return level;
+        }
+
+        RemoveLevelInstance( level );
+    }
+
+    const auto level = CreateLevelInstance( infos, instance_name );
+    if ( level.IsNone() )
+    {
+        UE_LOG( LogPLS, Warning, TEXT( "Could not create the level instance %s of %s" ), *instance_name.ToString(), *infos.Level.ToString() );
+        return NAME_None;
+    }
+
+    LevelInstances.Add( level, { instance_name, infos.Level.ToSoftObjectPath(), 1 } );
+    InstanceNameToLevelMap.Add( instance_name, level );
+
+    return level;
+}
+
+FName IPLSStreamingBackend::FindLevelInstance( const FPLSLevelInstanceInfos & infos ) const
+{
+    const auto level = InstanceNameToLevelMap.FindRef( infos.GetInstanceName() );
+    if ( level.IsNone() || LevelInstances.FindChecked( level ).SourceLevel != infos.Level.ToSoftObjectPath() )
+    {
+        return NAME_None;
+    }
+
+    return DoesLevelExist( level ) ? level : NAME_None;
+}
+
+bool IPLSStreamingBackend::IsLevelInstance( const FName level ) const
+{
+    return LevelInstances.Contains( level );
+}
+
+void IPLSStreamingBackend::ReleaseLevelInstance( const FName level )
+{
+    auto * level_instance = LevelInstances.Find( level );
+    if ( level_instance == nullptr || level_instance->AcquireCount == 0 )
+    {
+        return;
+    }
+
+    level_instance->AcquireCount--;
+    PoolLevelInstanceIfUnused( level );
+}
+
+void IPLSStreamingBackend::BroadcastLevelStateChanged( const FName level )
+{
+    OnLevelStateChangedDelegate.Broadcast( level );
+    PoolLevelInstanceIfUnused( level );
+}
+
+void IPLSStreamingBackend::PoolLevelInstanceIfUnused( const FName level )
+{
+    const auto * level_instance = LevelInstances.Find( level );
+
+    // Loaded instances, or the ones still being loaded, are pooled once they get unloaded
+    if ( level_instance == nullptr || level_instance->AcquireCount > 0 || ShouldLevelBeLoaded( level ) )
+    {
+        return;
+    }
+
+    PooledLevelInstances.Remove( level );
+    PooledLevelInstances.Add( level );
+
+    while ( PooledLevelInstances.Num() > FMath::Max( 0, GetMaxPooledLevelInstances() ) )
+    {
+        const auto oldest_level = PooledLevelInstances[ 0 ];
+        PooledLevelInstances.RemoveAt( 0 );
+
+        // It may have been requested again since it was released
+        if ( ShouldLevelBeLoaded( oldest_level ) )
+        {
+            continue;
+        }
+
+        DestroyLevelInstance( oldest_level );
+        RemoveLevelInstance( oldest_level );
+    }
+}
+
+void IPLSStreamingBackend::RemoveLevelInstance( const FName level )
+{
+    if ( const auto * level_instance = LevelInstances.Find( level ) )
+    {
+        InstanceNameToLevelMap.Remove( level_instance->InstanceName );
+    }
+
+    LevelInstances.Remove( level );
+    PooledLevelInstances.Remove( level );
+}
+
+FPLSLevelStreamingBackend::FPLSLevelStreamingBackend( UWorld * world ) :
+    WorldPtr( world )
+{
+    LevelStreamingStateChangedHandle = FLevelStreamingDelegates::OnLevelStreamingStateChanged.AddRaw( this, &FPLSLevelStreamingBackend::OnLevelStreamingStateChanged );
+}
+
+FPLSLevelStreamingBackend::~FPLSLevelStreamingBackend()
+{
+    FLevelStreamingDelegates::OnLevelStreamingStateChanged.Remove( LevelStreamingStateChangedHandle );
+}
+
+FName FPLSLevelStreamingBackend::FindLevel( const FSoftObjectPath & soft_object_path ) const
+{
+    auto * world = WorldPtr.Get();
+    if ( world == nullptr )
+    {
+        return NAME_None;
+    }
+
+    const auto safe_level_name = MakeSafeLevelName( soft_object_path, world );
+
+    for ( auto * level_streaming : world->GetStreamingLevels() )
+    {
+        if ( level_streaming != nullptr && IsMatchingStreamingLevel( level_streaming->GetWorldAssetPackageName(), safe_level_name ) )
+        {
+            const auto package_name = level_streaming->GetWorldAssetPackageFName();
+            LevelStreamingCache.Add( package_name, level_streaming );
+            return package_name;
+        }
+    }
+
+    return NAME_None;
+}
+
+void FPLSLevelStreamingBackend::GetLevels( TArray< FName > & levels ) const
+{
+    if ( const auto * world = WorldPtr.Get() )
+    {
+        for ( auto * level_streaming : world->GetStreamingLevels() )
+        {
+            // World partition cells are streamed by the world partition itself
+            if ( level_streaming != nullptr && !level_streaming->IsA< UWorldPartitionLevelStreamingDynamic >() )
+            {
+                levels.Add( level_streaming->GetWorldAssetPackageFName() );
+            }
+        }
+    }
+}
+
+bool FPLSLevelStreamingBackend::IsLevelLoaded( const FName level ) const
+{
+    const auto * level_streaming = GetLevelStreaming( level );
+    return level_streaming != nullptr && level_streaming->IsLevelLoaded();
+}
+
+bool FPLSLevelStreamingBackend::IsLevelVisible( const FName level ) const
+{
+    const auto * level_streaming = GetLevelStreaming( level );
+    return level_streaming != nullptr && level_streaming->IsLevelVisible();
+}
+
+bool FPLSLevelStreamingBackend::IsLevelAlwaysLoaded( const FName level ) const
+{
+    const auto * level_streaming = GetLevelStreaming( level );
+    return level_streaming != nullptr && level_streaming->ShouldBeAlwaysLoaded();
+}
+
+void FPLSLevelStreamingBackend::RequestLevelLoad( const FName level, const bool make_visible, const bool block_on_load )
+{
+    if ( auto * level_streaming = GetLevelStreaming( level ) )
+    {
+        level_streaming->SetShouldBeLoaded( true );
+        level_streaming->SetShouldBeVisible( make_visible );
+        level_streaming->bShouldBlockOnLoad = block_on_load;
+
+        NotifyPlayerControllers( level_streaming, true, make_visible, block_on_load );
+    }
+}
+
+void FPLSLevelStreamingBackend::RequestLevelUnload( const FName level, const bool unload, const bool block_on_unload )
+{
+    if ( auto * level_streaming = GetLevelStreaming( level ) )
+    {
+        level_streaming->SetShouldBeLoaded( !unload );
+        level_streaming->SetShouldBeVisible( false );
+        level_streaming->bShouldBlockOnUnload = block_on_unload;
+
+        NotifyPlayerControllers( level_streaming, !unload, false, block_on_unload );
+    }
+}
+
+double FPLSLevelStreamingBackend::GetTimeSeconds() const
+{
+    return FPlatformTime::Seconds();
+}
+
+int32 FPLSLevelStreamingBackend::GetPendingLoadCount() const
+{
+    return GetNumAsyncPackages();
+}
+
+FName FPLSLevelStreamingBackend::CreateLevelInstance( const FPLSLevelInstanceInfos & infos, const FName instance_name )
+{
+    auto * world = WorldPtr.Get();
+    if ( world == nullptr )
+    {
+        return NAME_None;
+    }
+
+    auto success = false;
+    auto * level_streaming = ULevelStreamingDynamic::LoadLevelInstanceBySoftObjectPtr( world, infos.Level, infos.Transform, success, instance_name.ToString() );
+
+    if ( !success || level_streaming == nullptr )
+    {
+        return NAME_None;
+    }
+
+    // Instances are created with the request to be loaded, but the request decides when it must happen
+    level_streaming->SetShouldBeLoaded( false );
+    level_streaming->SetShouldBeVisible( false );
+
+    const auto level = level_streaming->GetWorldAssetPackageFName();
+    LevelStreamingCache.Add( level, level_streaming );
+
+    return level;
+}
+
+void FPLSLevelStreamingBackend::DestroyLevelInstance( const FName level )
+{
+    if ( auto * level_streaming = GetLevelStreaming( level ) )
+    {
+        level_streaming->SetIsRequestingUnloadAndRemoval( true );
+    }
+
+    LevelStreamingCache.Remove( level );
+}
+
+bool FPLSLevelStreamingBackend::DoesLevelExist( const FName level ) const
+{
+    return GetLevelStreaming( level ) != nullptr;
+}
+
+bool FPLSLevelStreamingBackend::ShouldLevelBeLoaded( const FName level ) const
+{
+    const auto * level_streaming = GetLevelStreaming( level );
+    return level_streaming != nullptr && ( level_streaming->ShouldBeLoaded() || level_streaming->IsLevelLoaded() );
+}
+
+int32 FPLSLevelStreamingBackend::GetMaxPooledLevelInstances() const
+{
+    return CVarMaxPooledLevelInstances.GetValueOnGameThread();
+}
+
+ULevelStreaming * FPLSLevelStreamingBackend::GetLevelStreaming( const FName level ) const
+{
+    if ( const auto * cached_level_streaming = LevelStreamingCache.Find( level ) )
+    {
+        if ( auto * level_streaming = cached_level_streaming->Get() )
+        {
+            return level_streaming;
+        }
+    }
+
+    if ( const auto * world = WorldPtr.Get() )
+    {
+        for ( auto * level_streaming : world->GetStreamingLevels() )
+        {
+            if ( level_streaming != nullptr && level_streaming->GetWorldAssetPackageFName() == level )
+            {
+                LevelStreamingCache.Add( level, level_streaming );
+                return level_streaming;
+            }
+        }
+    }
+
+    LevelStreamingCache.Remove( level );
+    return nullptr;
+}
+
+FString FPLSLevelStreamingBackend::MakeSafeLevelName( const FSoftObjectPath & soft_object_path, UWorld * world )
+{
+    const auto level_name = FName( *FPackageName::ObjectPathToPackageName( soft_object_path.ToString() ) );
+    return world != nullptr ? FStreamLevelAction::MakeSafeLevelName( level_name, world ) : level_name.ToString();
+}
+
+bool FPLSLevelStreamingBackend::IsMatchingStreamingLevel( const FString & streaming_level_package_name, const FString & safe_level_name )
+{
+    return streaming_level_package_name.EndsWith( safe_level_name, ESearchCase::IgnoreCase );
+}
+
+void FPLSLevelStreamingBackend::NotifyPlayerControllers( ULevelStreaming * level_streaming, const bool should_be_loaded, const bool should_be_visible, const bool should_block ) const
+{
+    for ( auto iterator = WorldPtr->GetPlayerControllerIterator(); iterator; ++iterator )
+    {
+        if ( auto * player_controller = iterator->Get() )
+        {
+            player_controller->LevelStreamingStatusChanged(
+                level_streaming,
+                should_be_loaded,
+                should_be_visible,
+                should_block,
+                INDEX_NONE );
+        }
+    }
+}
+
+void FPLSLevelStreamingBackend::OnLevelStreamingStateChanged( UWorld * world, const ULevelStreaming * level_streaming, ULevel * /*level_if_loaded*/, ELevelStreamingState /*previous_state*/, ELevelStreamingState /*new_state*/ )
+{
+    if ( world != WorldPtr.Get() || level_streaming == nullptr )
+    {
+        return;
+    }
+
+    const auto level = level_streaming->GetWorldAssetPackageFName();
+
+    BroadcastLevelStateChanged( level );
+}
@@ -0,0 +1,111 @@
+#include "PLSStreamingThrottle.h"
+
+#include <HAL/IConsoleManager.h>
+
+namespace
+{
+    TAutoConsoleVariable< bool > CVarThrottleEnabled(
+        TEXT( "PLS.Throttle.Enabled" ),
+        true,
+        TEXT( "Limits the number of level transitions started each tick from the frame time and the async loading backlog" ) );
+
+    TAutoConsoleVariable< float > CVarThrottleTargetFrameTimeMs(
+        TEXT( "PLS.Throttle.TargetFrameTimeMs" ),
+        33.3f,
+        TEXT( "Frame time above which the number of level transitions started each tick is reduced" ) );
+
+    TAutoConsoleVariable< int32 > CVarThrottleMaxPendingLoads(
+        TEXT( "PLS.Throttle.MaxPendingLoads" ),
+        32,
+        TEXT( "Number of async packages in flight above which the number of level transitions started each tick is reduced" ) );
+
+    TAutoConsoleVariable< int32 > CVarThrottleMinTransitionsPerTick(
+        TEXT( "PLS.Throttle.MinTransitionsPerTick" ),
+        1,
+        TEXT( "Minimum number of level transitions a request can start each tick" ) );
+
+    TAutoConsoleVariable< int32 > CVarThrottleMaxTransitionsPerTick(
+        TEXT( "PLS.Throttle.MaxTransitionsPerTick" ),
+        16,
+        TEXT( "Maximum number of level transitions a request can start each tick" ) );
+
+    constexpr float FrameTimeSmoothing = 0.1f;
+    // A single frame this much over the target is a hitch, and reduces the limit without waiting for the average to catch up
+    constexpr float HitchFactor = 1.5f;
+    // The limit only grows when there is some margin, to avoid oscillating around the target
+    constexpr float HeadroomFactor = 0.8f;
+}
+
+FPLSStreamingThrottle::FPLSStreamingThrottle() :
+    AverageFrameTime( 0.0f ),
+    MaxTransitionsPerTick( MAX_int32 ),
+    bIsBlockingAllowed( false ),
+    FrameBudgetFrame( MAX_uint64 ),
+    RemainingFrameBudget( 0 )
+{
+}
+
+void FPLSStreamingThrottle::Update( const float delta_seconds, const int32 pending_load_count )
+{
+    AverageFrameTime = AverageFrameTime > 0.0f
+                           ? FMath::Lerp( AverageFrameTime, delta_seconds, FrameTimeSmoothing )
+                           : delta_seconds;
+
+    if ( !CVarThrottleEnabled.GetValueOnGameThread() || bIsBlockingAllowed )
+    {
+        MaxTransitionsPerTick = MAX_int32;
+        return;
+    }
+
+    const auto min_transitions = FMath::Max( 1, CVarThrottleMinTransitionsPerTick.GetValueOnGameThread() );
+    const auto max_transitions = FMath::Max( min_transitions, CVarThrottleMaxTransitionsPerTick.GetValueOnGameThread() );
+    const auto target_frame_time = CVarThrottleTargetFrameTimeMs.GetValueOnGameThread() / 1000.0f;
+    const auto max_pending_loads = CVarThrottleMaxPendingLoads.GetValueOnGameThread();
+
+    // Coming back from an unlimited state
+    MaxTransitionsPerTick = FMath::Clamp( MaxTransitionsPerTick, min_transitions, max_transitions );
+
+    const auto is_over_budget = delta_seconds > target_frame_time * HitchFactor
+                                || AverageFrameTime > target_frame_time
+                                || pending_load_count > max_pending_loads;
+
+    if ( is_over_budget )
+    {
+        MaxTransitionsPerTick = FMath::Max( min_transitions, MaxTransitionsPerTick / 2 );
+    }
+    else if ( AverageFrameTime < target_frame_time * HeadroomFactor && pending_load_count < max_pending_loads / 2 )
+    {
+        MaxTransitionsPerTick = FMath::Min( max_transitions, MaxTransitionsPerTick + 1 );
+    }
+}
+
+void FPLSStreamingThrottle::SetBlockingAllowed( const bool is_blocking_allowed )
+{
+    bIsBlockingAllowed = is_blocking_allowed;
+
+    if ( bIsBlockingAllowed )
+    {
+        MaxTransitionsPerTick = MAX_int32;
+    }
+}
+
+int32 FPLSStreamingThrottle::AcquireFrameBudget( const uint64 frame )
+{
+    if ( FrameBudgetFrame != frame )
+    {
+        FrameBudgetFrame = frame;
+        RemainingFrameBudget = MaxTransitionsPerTick;
+    }
+
+    const auto budget = RemainingFrameBudget;
+    RemainingFrameBudget = 0;
+    return budget;
+}
+
+void FPLSStreamingThrottle::ReleaseFrameBudget( const uint64 frame, const int32 remaining_budget )
+{
+    if ( FrameBudgetFrame == frame )
+    {
+        RemainingFrameBudget = FMath::Max( 0, remaining_budget );
+    }
+}
@@ -1,6 +1,133 @@
 #include "PLSSubsystem.h"
 
+#include "PortalLevelStreaming.h"
+
 #include <Engine/LevelStreaming.h>
+#include <Engine/World.h>
+#include <HAL/IConsoleManager.h>
+#include <Misc/App.h>
+#include <Misc/DateTime.h>
+#include <Misc/Paths.h>
+
+namespace
+{
+    TAutoConsoleVariable< float > CVarStuckLevelTimeout(
+        TEXT( "PLS.Debug.StuckLevelTimeout" ),
+        30.0f,
+        TEXT( "Number of seconds after which a level which did not reach the state requested by the executing request is reported as stuck. 0 to disable" ) );
+
+    UPLSSubsystem * GetPLSSubsystem( const UWorld * world )
+    {
+        return world != nullptr ? world->GetSubsystem< UPLSSubsystem >() : nullptr;
+    }
+
+    FAutoConsoleCommandWithWorldAndArgs StartTraceCommand(
+        TEXT( "PLS.Trace.Start" ),
+        TEXT( "Starts recording the portal level streaming requests and level state transitions of the current world" ),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda( []( const TArray< FString > & /*args*/, UWorld * world ) {
+            if ( auto * pls_subsystem = GetPLSSubsystem( world ) )
+            {
+                pls_subsystem->StartTraceRecording();
+            }
+        } ) );
+
+    FAutoConsoleCommandWithWorldAndArgs StopTraceCommand(
+        TEXT( "PLS.Trace.Stop" ),
+        TEXT( "Stops the portal level streaming trace recording and saves it. Optional argument : the file name, saved under Saved/Profiling/PLS" ),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda( []( const TArray< FString > & args, UWorld * world ) {
+            if ( auto * pls_subsystem = GetPLSSubsystem( world ) )
+            {
+                const auto file_name = args.Num() > 0 ? args[ 0 ] : FString::Printf( TEXT( "PLS-%s.plstrace" ), *FDateTime::Now().ToString() );
+                pls_subsystem->StopTraceRecording( FPaths::ProfilingDir() / TEXT( "PLS" ) / file_name );
+            }
+        } ) );
+
+    FAutoConsoleCommandWithWorldAndArgs DumpRequestsCommand(
+        TEXT( "PLS.Requests.Dump" ),
+        TEXT( "Prints the portal level streaming requests, and the status of the levels of the executing request" ),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda( []( const TArray< FString > & /*args*/, UWorld * world ) {
+            if ( const auto * pls_subsystem = GetPLSSubsystem( world ) )
+            {
+                TArray< FPLSDebugLine > lines;
+                FPLSDebugOverlay::GetDebugLines( *pls_subsystem, lines );
+
+                for ( const auto & line : lines )
+                {
+                    if ( line.bIsStuck )
+                    {
+                        UE_LOG( LogPLS, Warning, TEXT( "%s" ), *line.Text );
+                    }
+                    else
+                    {
+                        UE_LOG( LogPLS, Display, TEXT( "%s" ), *line.Text );
+                    }
+                }
+            }
+        } ) );
+
+    FAutoConsoleCommandWithWorldAndArgs CancelRequestsCommand(
+        TEXT( "PLS.Requests.Cancel" ),
+        TEXT( "Cancels a portal level streaming request without calling its executed delegate. Argument : the handle of the request, or all" ),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda( []( const TArray< FString > & args, UWorld * world ) {
+            auto * pls_subsystem = GetPLSSubsystem( world );
+            if ( pls_subsystem == nullptr || args.Num() == 0 )
+            {
+                return;
+            }
+
+            TArray< FPLSLevelStreamingRequestHandle > handles;
+
+            if ( args[ 0 ] == TEXT( "all" ) )
+            {
+                for ( const auto * request : pls_subsystem->GetRequests() )
+                {
+                    handles.Add( request->GetHandle() );
+                }
+            }
+            else if ( FCString::IsNumeric( *args[ 0 ] ) )
+            {
+                const auto handle_value = FCString::Atoi( *args[ 0 ] );
+
+                for ( const auto * request : pls_subsystem->GetRequests() )
+                {
+                    if ( request->GetHandle().GetValue() == handle_value )
+                    {
+                        handles.Add( request->GetHandle() );
+                    }
+                }
+
+                if ( handles.IsEmpty() )
+                {
+                    UE_LOG( LogPLS, Warning, TEXT( "There is no portal level streaming request with the handle %i" ), handle_value );
+                }
+            }
+            else
+            {
+                UE_LOG( LogPLS, Warning, TEXT( "Invalid argument %s : expected the handle of a request, or all" ), *args[ 0 ] );
+            }
+
+            // Cancel the queued requests first, so cancelling the executing one does not start the next one for nothing
+            for ( auto index = handles.Num() - 1; index >= 0; --index )
+            {
+                pls_subsystem->CancelRequest( handles[ index ] );
+                UE_LOG( LogPLS, Warning, TEXT( "Cancelled request %s" ), *handles[ index ].ToString() );
+            }
+        } ) );
+
+    FAutoConsoleCommandWithWorldAndArgs ForceRequestCommand(
+        TEXT( "PLS.Requests.Force" ),
+        TEXT( "Stops waiting for the levels of the current step of the executing portal level streaming request, so a stalled request lets the queue move on" ),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda( []( const TArray< FString > & /*args*/, UWorld * world ) {
+            if ( const auto * pls_subsystem = GetPLSSubsystem( world ) )
+            {
+                const auto & requests = pls_subsystem->GetRequests();
+                if ( !requests.IsEmpty() && requests[ 0 ]->IsExecuting() )
+                {
+                    requests[ 0 ]->SkipPendingLevels();
+                }
+            }
+        } ) );
+}
 
 FPLSLevelStreamingRequestHandle UPLSSubsystem::K2_AddRequest( const FPLSLevelStreamingInfos & infos, const FPLSOnRequestExecutedDynamicDelegate & request_executed_delegate, bool cancel_existing_requests )
 {
@@ -18,8 +145,17 @@ FPLSLevelStreamingRequestHandle UPLSSubsystem::AddRequest( const FPLSLevelStream
 
     if ( cancel_existing_requests )
     {
+        if ( !Requests.IsEmpty() )
+        {
+            ReleaseTransitionBudget( *Requests[ 0 ] );
+        }
+
         for ( const auto & request : Requests )
         {
+            if ( TraceRecorder.IsValid() )
+            {
+                TraceRecorder->RecordRequestEvent( EPLSTraceEventType::RequestCancelled, request->GetHandle() );
+            }
             request->Cancel();
         }
         Requests.Reset();
@@ -32,7 +168,12 @@ FPLSLevelStreamingRequestHandle UPLSSubsystem::AddRequest( const FPLSLevelStream
         OnRequestExecuted( handle );
     } );
 
-    request->Initialize( infos, executed_delegate );
+    request->Initialize( infos, Backend.ToSharedRef(), executed_delegate );
+
+    if ( TraceRecorder.IsValid() )
+    {
+        TraceRecorder->RecordRequestAdded( *request, cancel_existing_requests );
+    }
 
     Requests.Emplace( request );
 
@@ -65,8 +206,145 @@ void UPLSSubsystem::CallOrRegister_OnAllRequestsFinished( FPLSOnAllRequestsFinis
     }
 }
 
+bool UPLSSubsystem::CancelRequest( const FPLSLevelStreamingRequestHandle request_handle )
+{
+    const auto index = Requests.IndexOfByPredicate( [ request_handle ]( const auto * request ) {
+        return request->GetHandle() == request_handle;
+    } );
+
+    if ( index == INDEX_NONE )
+    {
+        return false;
+    }
+
+    if ( TraceRecorder.IsValid() )
+    {
+        TraceRecorder->RecordRequestEvent( EPLSTraceEventType::RequestCancelled, request_handle );
+    }
+
+    if ( index == 0 )
+    {
+        ReleaseTransitionBudget( *Requests[ index ] );
+    }
+
+    Requests[ index ]->Cancel();
+    Requests.RemoveAt( index );
+    RequestHandleToInfosMap.Remove( request_handle );
+
+    if ( index == 0 )
+    {
+        ProcessNextRequest();
+    }
+
+    return true;
+}
+
+void UPLSSubsystem::Initialize( FSubsystemCollectionBase & collection )
+{
+    Super::Initialize( collection );
+
+    Backend = MakeShared< FPLSLevelStreamingBackend >( GetWorld() );
+    DebugOverlay = MakeUnique< FPLSDebugOverlay >( *this );
+}
+
+void UPLSSubsystem::Deinitialize()
+{
+    DebugOverlay.Reset();
+    TraceRecorder.Reset();
+    Backend.Reset();
+
+    Super::Deinitialize();
+}
+
+void UPLSSubsystem::Tick( const float delta_time )
+{
+    Super::Tick( delta_time );
+
+    // The world delta time is dilated and clamped : the throttle needs the real duration of the frame
+    Throttle.Update( FApp::GetDeltaTime(), Backend->GetPendingLoadCount() );
+
+    // A request which started earlier in this frame already received the budget of the frame
+    if ( !Requests.IsEmpty() && Requests[ 0 ]->IsExecuting() && !Throttle.IsFrameBudgetAcquired( GFrameCounter ) )
+    {
+        Requests[ 0 ]->SetTransitionBudget( Throttle.AcquireFrameBudget( GFrameCounter ), Throttle.ShouldBlock() );
+    }
+
+    // The budget may have completed the request
+    const auto stuck_level_timeout = CVarStuckLevelTimeout.GetValueOnGameThread();
+    if ( stuck_level_timeout > 0.0f && !Requests.IsEmpty() && Requests[ 0 ]->IsExecuting() )
+    {
+        Requests[ 0 ]->ReportStuckLevels( stuck_level_timeout );
+    }
+}
+
+TStatId UPLSSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT( UPLSSubsystem, STATGROUP_Tickables );
+}
+
+void UPLSSubsystem::SetLoadingScreenVisible( const bool is_visible )
+{
+    Throttle.SetBlockingAllowed( is_visible );
+}
+
+void UPLSSubsystem::SetBackend( const TSharedRef< IPLSStreamingBackend > & backend )
+{
+    check( Requests.IsEmpty() );
+
+    Backend = backend;
+}
+
+void UPLSSubsystem::StartTraceRecording()
+{
+    TraceRecorder = MakeUnique< FPLSTraceRecorder >( Backend.ToSharedRef() );
+
+    UE_LOG( LogPLS, Log, TEXT( "Started recording a portal level streaming trace" ) );
+}
+
+bool UPLSSubsystem::StopTraceRecording( const FString & file_path )
+{
+    if ( !TraceRecorder.IsValid() )
+    {
+        UE_LOG( LogPLS, Warning, TEXT( "Can not stop the portal level streaming trace recording : it was not started" ) );
+        return false;
+    }
+
+    const auto & trace = TraceRecorder->GetTrace();
+
+    if ( trace.Requests.IsEmpty() && trace.Events.IsEmpty() )
+    {
+        UE_LOG( LogPLS, Warning, TEXT( "The portal level streaming trace is empty : nothing is saved" ) );
+        TraceRecorder.Reset();
+        return false;
+    }
+
+    const auto result = trace.SaveToFile( file_path );
+    TraceRecorder.Reset();
+
+    if ( result )
+    {
+        UE_LOG( LogPLS, Log, TEXT( "Saved the portal level streaming trace to %s" ), *file_path );
+    }
+    else
+    {
+        UE_LOG( LogPLS, Error, TEXT( "Failed to save the portal level streaming trace to %s" ), *file_path );
+    }
+
+    return result;
+}
+
 void UPLSSubsystem::OnRequestExecuted( FPLSLevelStreamingRequestHandle handle )
 {
+    if ( TraceRecorder.IsValid() )
+    {
+        TraceRecorder->RecordRequestEvent( EPLSTraceEventType::RequestExecuted, handle );
+    }
+
+    if ( !Requests.IsEmpty() && Requests[ 0 ]->GetHandle() == handle )
+    {
+        ReleaseTransitionBudget( *Requests[ 0 ] );
+    }
+
     Requests.RemoveAll( [ handle ]( auto * request ) {
         const auto result = request->GetHandle() == handle;
         check( !request->IsExecuting() );
@@ -95,5 +373,16 @@ void UPLSSubsystem::ProcessNextRequest()
         return;
     }
 
+    if ( TraceRecorder.IsValid() )
+    {
+        TraceRecorder->RecordRequestEvent( EPLSTraceEventType::RequestStarted, request->GetHandle() );
+    }
+
+    request->SetTransitionBudget( Throttle.AcquireFrameBudget( GFrameCounter ), Throttle.ShouldBlock() );
     request->Process();
+}
+
+void UPLSSubsystem::ReleaseTransitionBudget( const UPLSRequest & request )
+{
+    Throttle.ReleaseFrameBudget( GFrameCounter, request.GetTransitionBudget() );
 }
\ No newline at end of file
@@ -0,0 +1,311 @@
+#include "PLSTrace.h"
+
+#include "PortalLevelStreaming.h"
+
+#include <Misc/FileHelper.h>
+#include <Serialization/MemoryReader.h>
+#include <Serialization/MemoryWriter.h>
+
+namespace
+{
+    // 'PLST'
+    constexpr uint32 TraceMagic = 0x54534C50;
+    constexpr uint32 TraceVersion = 1;
+
+    template < typename _ENUM_TYPE_ >
+    void SerializeEnum( FArchive & archive, _ENUM_TYPE_ & value )
+    {
+        auto raw_value = static_cast< uint8 >( value );
+        archive << raw_value;
+        value = static_cast< _ENUM_TYPE_ >( raw_value );
+    }
+
+    void SerializeBool( FArchive & archive, bool & value )
+    {
+        uint8 raw_value = value ? 1 : 0;
+        archive << raw_value;
+        value = raw_value != 0;
+    }
+}
+
+bool FPLSTrace::SaveToFile( const FString & file_path ) const
+{
+    TArray< uint8 > bytes;
+    FMemoryWriter writer( bytes );
+
+    if ( !const_cast< FPLSTrace * >( this )->Serialize( writer ) )
+    {
+        return false;
+    }
+
+    return FFileHelper::SaveArrayToFile( bytes, *file_path );
+}
+
+bool FPLSTrace::LoadFromFile( const FString & file_path )
+{
+    TArray< uint8 > bytes;
+    if ( !FFileHelper::LoadFileToArray( bytes, *file_path ) )
+    {
+        return false;
+    }
+
+    FMemoryReader reader( bytes );
+    return Serialize( reader );
+}
+
+void FPLSTrace::Reset()
+{
+    Requests.Reset();
+    Events.Reset();
+}
+
+bool FPLSTrace::Serialize( FArchive & archive )
+{
+    auto magic = TraceMagic;
+    auto version = TraceVersion;
+
+    archive << magic;
+    archive << version;
+
+    if ( archive.IsLoading() && ( magic != TraceMagic || version != TraceVersion ) )
+    {
+        UE_LOG( LogPLS, Error, TEXT( "Invalid portal level streaming trace (magic %08x, version %u)" ), magic, version );
+        return false;
+    }
+
+    // Level names are stored once in a table and referenced by index by the requests and the events
+    TArray< FName > names;
+    TMap< FName, int32 > name_indices;
+
+    if ( archive.IsSaving() )
+    {
+        const auto add_name = [ &names, &name_indices ]( const FName name ) {
+            if ( !name_indices.Contains( name ) )
+            {
+                name_indices.Add( name, names.Add( name ) );
+            }
+        };
+
+        for ( const auto & request : Requests )
+        {
+            for ( const auto & level : request.LevelsToLoad )
+            {
+                add_name( level.PackageName );
+            }
+            for ( const auto & level : request.LevelsToUnload )
+            {
+                add_name( level.PackageName );
+            }
+        }
+
+        for ( const auto & event : Events )
+        {
+            add_name( event.LevelPackageName );
+        }
+    }
+
+    // The counts read from a truncated or corrupted file can not be trusted : each element takes at least one byte, so no count can exceed what is left to read
+    const auto serialize_count = [ &archive ]( int32 & count ) {
+        archive << count;
+
+        if ( archive.IsLoading() && ( archive.IsError() || count < 0 || count > archive.TotalSize() - archive.Tell() ) )
+        {
+            UE_LOG( LogPLS, Error, TEXT( "Corrupted portal level streaming trace" ) );
+            archive.SetError();
+            return false;
+        }
+
+        return true;
+    };
+
+    auto name_count = names.Num();
+    if ( !serialize_count( name_count ) )
+    {
+        return false;
+    }
+
+    if ( archive.IsLoading() )
+    {
+        names.Reserve( name_count );
+    }
+
+    for ( auto index = 0; index < name_count; ++index )
+    {
+        auto name_string = archive.IsSaving() ? names[ index ].ToString() : FString();
+        archive << name_string;
+
+        if ( archive.IsLoading() )
+        {
+            names.Add( FName( *name_string ) );
+        }
+    }
+
+    const auto serialize_name = [ &archive, &names, &name_indices ]( FName & name ) {
+        auto index = archive.IsSaving() ? name_indices.FindChecked( name ) : INDEX_NONE;
+        archive << index;
+
+        if ( archive.IsLoading() )
+        {
+            name = names.IsValidIndex( index ) ? names[ index ] : NAME_None;
+        }
+    };
+
+    auto request_count = Requests.Num();
+    if ( !serialize_count( request_count ) )
+    {
+        return false;
+    }
+
+    if ( archive.IsLoading() )
+    {
+        Requests.Reset( request_count );
+        Requests.AddDefaulted( request_count );
+    }
+
+    for ( auto & request : Requests )
+    {
+        archive << request.RequestHandle;
+        archive << request.Time;
+        SerializeBool( archive, request.bCancelExistingRequests );
+        SerializeEnum( archive, request.LoadOrder );
+
+        auto load_count = request.LevelsToLoad.Num();
+        if ( !serialize_count( load_count ) )
+        {
+            return false;
+        }
+        request.LevelsToLoad.SetNum( load_count );
+
+        for ( auto & level : request.LevelsToLoad )
+        {
+            serialize_name( level.PackageName );
+            SerializeBool( archive, level.bBlockOnLoad );
+            SerializeEnum( archive, level.LoadType );
+
+            auto prerequisite_count = level.Prerequisites.Num();
+            if ( !serialize_count( prerequisite_count ) )
+            {
+                return false;
+            }
+            level.Prerequisites.SetNum( prerequisite_count );
+
+            for ( auto & prerequisite : level.Prerequisites )
+            {
+                serialize_name( prerequisite );
+            }
+        }
+
+        auto unload_count = request.LevelsToUnload.Num();
+        if ( !serialize_count( unload_count ) )
+        {
+            return false;
+        }
+        request.LevelsToUnload.SetNum( unload_count );
+
+        for ( auto & level : request.LevelsToUnload )
+        {
+            serialize_name( level.PackageName );
+            SerializeBool( archive, level.bBlockOnUnload );
+            SerializeEnum( archive, level.UnloadType );
+        }
+    }
+
+    auto event_count = Events.Num();
+    if ( !serialize_count( event_count ) )
+    {
+        return false;
+    }
+
+    if ( archive.IsLoading() )
+    {
+        Events.Reset( event_count );
+        Events.AddDefaulted( event_count );
+    }
+
+    for ( auto & event : Events )
+    {
+        archive << event.Time;
+        SerializeEnum( archive, event.Type );
+        archive << event.RequestHandle;
+        serialize_name( event.LevelPackageName );
+        archive << event.Param0;
+        archive << event.Param1;
+    }
+
+    return !archive.IsError();
+}
+
+FPLSTraceRecorder::FPLSTraceRecorder( const TSharedRef< IPLSStreamingBackend > & backend ) :
+    Backend( backend ),
+    StartTime( backend->GetTimeSeconds() )
+{
+    LevelStateChangedHandle = Backend->OnLevelStateChanged().AddRaw( this, &FPLSTraceRecorder::OnLevelStateChanged );
+}
+
+FPLSTraceRecorder::~FPLSTraceRecorder()
+{
+    Backend->OnLevelStateChanged().Remove( LevelStateChangedHandle );
+}
+
+void FPLSTraceRecorder::RecordRequestAdded( const UPLSRequest & request, const bool cancel_existing_requests )
+{
+    auto & trace_request = Trace.Requests.AddDefaulted_GetRef();
+    trace_request.RequestHandle = request.GetHandle().GetValue();
+    trace_request.Time = GetTime();
+    trace_request.bCancelExistingRequests = cancel_existing_requests;
+    trace_request.LoadOrder = request.GetLoadOrder();
+
+    for ( const auto & pair : request.GetLevelsToLoad() )
+    {
+        auto & level = trace_request.LevelsToLoad.AddDefaulted_GetRef();
+        level.PackageName = pair.Key;
+        level.bBlockOnLoad = pair.Value.bBlockOnLoad;
+        level.LoadType = pair.Value.LoadType;
+        level.Prerequisites = pair.Value.Prerequisites;
+    }
+
+    for ( const auto & pair : request.GetLevelsToUnload() )
+    {
+        auto & level = trace_request.LevelsToUnload.AddDefaulted_GetRef();
+        level.PackageName = pair.Key;
+        level.bBlockOnUnload = pair.Value.bBlockOnUnload;
+        level.UnloadType = pair.Value.UnloadType;
+    }
+
+    RecordRequestEvent( EPLSTraceEventType::RequestAdded, request.GetHandle() );
+}
+
+void FPLSTraceRecorder::RecordRequestEvent( const EPLSTraceEventType event_type, const FPLSLevelStreamingRequestHandle handle )
+{
+    auto & event = Trace.Events.AddDefaulted_GetRef();
+    event.Time = GetTime();
+    event.Type = event_type;
+    event.RequestHandle = handle.GetValue();
+}
+
+void FPLSTraceRecorder::RecordLevelRequested( const FPLSLevelStreamingRequestHandle handle, const FName level_package_name, const bool should_be_loaded, const bool should_be_visible )
+{
+    auto & event = Trace.Events.AddDefaulted_GetRef();
+    event.Time = GetTime();
+    event.Type = EPLSTraceEventType::LevelRequested;
+    event.RequestHandle = handle.GetValue();
+    event.LevelPackageName = level_package_name;
+    event.Param0 = should_be_loaded ? 1 : 0;
+    event.Param1 = should_be_visible ? 1 : 0;
+}
+
+double FPLSTraceRecorder::GetTime() const
+{
+    // The default backend uses the wall clock rather than the world time, so hitches caused by blocking loads inside a single frame are visible
+    return Backend->GetTimeSeconds() - StartTime;
+}
+
+void FPLSTraceRecorder::OnLevelStateChanged( const FName level )
+{
+    auto & event = Trace.Events.AddDefaulted_GetRef();
+    event.Time = GetTime();
+    event.Type = EPLSTraceEventType::LevelStateChanged;
+    event.LevelPackageName = level;
+    event.Param0 = Backend->IsLevelLoaded( level ) ? 1 : 0;
+    event.Param1 = Backend->IsLevelVisible( level ) ? 1 : 0;
+}
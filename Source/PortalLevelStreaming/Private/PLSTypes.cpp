@@ -1 +1,43 @@
-#include "PLSTypes.h"
\ No newline at end of file
+#include "PLSTypes.h"
+
+#if WITH_EDITOR
+#include "PLSConfigValidator.h"
+
+#include <Misc/DataValidation.h>
+#endif
+
+#if WITH_EDITOR
+EDataValidationResult UPLSLevelGroup::IsDataValid( FDataValidationContext & context ) const
+{
+    auto result = CombineDataValidationResults( Super::IsDataValid( context ), EDataValidationResult::Valid );
+
+    TArray< FPLSValidationIssue > issues;
+    FPLSConfigValidator::ValidateLevelGroup( *this, issues );
+
+    for ( const auto & issue : issues )
+    {
+        if ( issue.Severity == EPLSValidationSeverity::Error )
+        {
+            context.AddError( FText::FromString( issue.Message ) );
+            result = EDataValidationResult::Invalid;
+        }
+        else
+        {
+            context.AddWarning( FText::FromString( issue.Message ) );
+        }
+    }
+
+    return result;
+}
+#endif
+
+FName FPLSLevelInstanceInfos::GetInstanceName() const
+{
+    if ( !InstanceName.IsNone() )
+    {
+        return InstanceName;
+    }
+
+    // The full package path keeps apart the levels which share the same asset name in different folders
+    return FName( *FString::Printf( TEXT( "%s_Instance_%08x" ), *Level.GetLongPackageName(), GetTypeHash( Transform.ToString() ) ) );
+}
\ No newline at end of file
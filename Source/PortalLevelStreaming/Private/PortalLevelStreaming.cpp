@@ -2,6 +2,8 @@
 
 #define LOCTEXT_NAMESPACE "FPortalLevelStreamingModule"
 
+DEFINE_LOG_CATEGORY( LogPLS );
+
 void FPortalLevelStreamingModule::StartupModule()
 {
 }
@@ -0,0 +1,158 @@
+#include "PLSConfigValidator.h"
+#include "PLSTypes.h"
+
+#include <Misc/AutomationTest.h>
+
+#if WITH_EDITOR && WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    constexpr auto ValidatorTestFlags = EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter;
+
+    // A map which ships with the engine, so the tests do not need any content
+    const TCHAR * const ExistingLevelPath = TEXT( "/Engine/Maps/Entry.Entry" );
+    const TCHAR * const MissingLevelPath = TEXT( "/Game/PLSTests/Missing.Missing" );
+
+    bool HasIssue( const TArray< FPLSValidationIssue > & issues, const EPLSValidationSeverity severity, const TCHAR * message )
+    {
+        return issues.ContainsByPredicate( [ severity, message ]( const auto & issue ) {
+            return issue.Severity == severity && issue.Message.Contains( message );
+        } );
+    }
+
+    FPLSLevelStreamingInfos MakeValidatorTestStreamingInfos( const FPLSLevelStreamingLevelInfos & levels_to_load, const FPLSLevelStreamingLevelInfos & levels_to_unload )
+    {
+        FPLSLevelStreamingInfos infos;
+        infos.UnloadCurrentStreamingLevelsInfos.bUnloadCurrentlyLoadedStreamingLevels = false;
+        infos.LevelsToLoad.AddDefaulted_GetRef().Levels = levels_to_load;
+        infos.LevelsToUnload.AddDefaulted_GetRef().Levels = levels_to_unload;
+        return infos;
+    }
+
+    UPLSLevelGroup * MakeValidatorTestLevelGroup( const TArray< const TCHAR * > & level_paths )
+    {
+        auto * level_group = NewObject< UPLSLevelGroup >( GetTransientPackage() );
+        for ( const auto * level_path : level_paths )
+        {
+            level_group->Levels.Emplace( level_path );
+        }
+        return level_group;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FPLSConfigValidatorMissingLevelTest, "PortalLevelStreaming.ConfigValidator.MissingLevel", ValidatorTestFlags )
+
+bool FPLSConfigValidatorMissingLevelTest::RunTest( const FString & /*parameters*/ )
+{
+    FPLSLevelStreamingLevelInfos levels_to_load;
+    levels_to_load.IndividualLevels.Emplace( MissingLevelPath );
+
+    FPLSLevelInstanceInfos level_instance;
+    level_instance.Level = TSoftObjectPtr< UWorld >( FSoftObjectPath( MissingLevelPath ) );
+    level_instance.InstanceName = TEXT( "Missing_1" );
+
+    FPLSLevelStreamingLevelInfos levels_to_unload;
+    levels_to_unload.LevelInstances.Add( level_instance );
+
+    FPLSConfigValidator validator;
+    validator.ValidateStreamingInfos( TEXT( "Test" ), MakeValidatorTestStreamingInfos( levels_to_load, levels_to_unload ), nullptr );
+
+    const auto & report = validator.GetReports()[ 0 ];
+    TestTrue( TEXT( "The missing level is reported" ), HasIssue( report.Issues, EPLSValidationSeverity::Error, TEXT( "Level /Game/PLSTests/Missing does not exist" ) ) );
+    TestTrue( TEXT( "The level instance to unload is validated" ), HasIssue( report.Issues, EPLSValidationSeverity::Error, TEXT( "Level instance Missing_1 references a level which does not exist" ) ) );
+    TestTrue( TEXT( "The missing level is not loaded" ), report.LevelsToLoad.IsEmpty() );
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FPLSConfigValidatorStreamingLevelTest, "PortalLevelStreaming.ConfigValidator.StreamingLevel", ValidatorTestFlags )
+
+bool FPLSConfigValidatorStreamingLevelTest::RunTest( const FString & /*parameters*/ )
+{
+    FPLSLevelStreamingLevelInfos levels_to_load;
+    levels_to_load.IndividualLevels.Emplace( ExistingLevelPath );
+
+    const TSet< FName > world_streaming_levels = { TEXT( "/Engine/Maps/Entry" ) };
+    const TSet< FName > other_world_streaming_levels = { TEXT( "/Engine/Maps/Other" ) };
+
+    FPLSConfigValidator validator;
+    validator.ValidateStreamingInfos( TEXT( "World" ), MakeValidatorTestStreamingInfos( levels_to_load, {} ), &world_streaming_levels );
+    validator.ValidateStreamingInfos( TEXT( "OtherWorld" ), MakeValidatorTestStreamingInfos( levels_to_load, {} ), &other_world_streaming_levels );
+
+    TestEqual( TEXT( "The streaming level of the world is found" ), validator.GetReports()[ 0 ].Issues.Num(), 0 );
+    TestTrue( TEXT( "The level is loaded" ), validator.GetReports()[ 0 ].LevelsToLoad.Contains( TEXT( "/Engine/Maps/Entry" ) ) );
+    TestTrue( TEXT( "A level which is not a streaming level of the world is reported" ), HasIssue( validator.GetReports()[ 1 ].Issues, EPLSValidationSeverity::Error, TEXT( "is not a streaming level of the world" ) ) );
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FPLSConfigValidatorLoadedAndUnloadedTest, "PortalLevelStreaming.ConfigValidator.LoadedAndUnloaded", ValidatorTestFlags )
+
+bool FPLSConfigValidatorLoadedAndUnloadedTest::RunTest( const FString & /*parameters*/ )
+{
+    FPLSLevelStreamingLevelInfos levels;
+    levels.IndividualLevels.Emplace( ExistingLevelPath );
+
+    FPLSConfigValidator validator;
+    validator.ValidateStreamingInfos( TEXT( "Test" ), MakeValidatorTestStreamingInfos( levels, levels ), nullptr );
+
+    const auto & report = validator.GetReports()[ 0 ];
+    TestTrue( TEXT( "The level both loaded and unloaded is reported" ), HasIssue( report.Issues, EPLSValidationSeverity::Warning, TEXT( "is both loaded and unloaded" ) ) );
+    TestTrue( TEXT( "The level is loaded" ), report.LevelsToLoad.Contains( TEXT( "/Engine/Maps/Entry" ) ) );
+    TestTrue( TEXT( "The unload is ignored" ), report.LevelsToUnload.IsEmpty() );
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FPLSConfigValidatorSharedLevelTest, "PortalLevelStreaming.ConfigValidator.SharedLevel", ValidatorTestFlags )
+
+bool FPLSConfigValidatorSharedLevelTest::RunTest( const FString & /*parameters*/ )
+{
+    const auto * level_group_a = MakeValidatorTestLevelGroup( { ExistingLevelPath } );
+    const auto * level_group_b = MakeValidatorTestLevelGroup( { ExistingLevelPath } );
+
+    FPLSConfigValidator validator;
+    validator.ValidateLevelGroup( *level_group_a );
+    validator.ValidateLevelGroup( *level_group_b );
+
+    // Computing the overlaps again must not report the shared levels twice
+    validator.ComputeOverlaps();
+    validator.ComputeOverlaps();
+
+    for ( const auto * level_group : { level_group_a, level_group_b } )
+    {
+        const auto issues = validator.GetLevelGroupIssues( level_group->GetPathName() );
+        TestEqual( TEXT( "The shared level is reported once for each group" ), issues.Num(), 1 );
+        TestTrue( TEXT( "The shared level is reported" ), HasIssue( issues, EPLSValidationSeverity::Warning, TEXT( "is shared by 2 groups" ) ) );
+    }
+
+    TestEqual( TEXT( "Warning count" ), validator.GetWarningCount(), 2 );
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FPLSConfigValidatorGroupCycleTest, "PortalLevelStreaming.ConfigValidator.GroupCycle", ValidatorTestFlags )
+
+bool FPLSConfigValidatorGroupCycleTest::RunTest( const FString & /*parameters*/ )
+{
+    auto * level_group_a = MakeValidatorTestLevelGroup( {} );
+    auto * level_group_b = MakeValidatorTestLevelGroup( {} );
+    level_group_a->Dependencies.Add( level_group_b );
+    level_group_b->Dependencies.Add( level_group_a );
+
+    FPLSConfigValidator validator;
+    validator.ValidateLevelGroup( *level_group_a );
+    validator.ValidateLevelGroup( *level_group_b );
+    validator.ComputeOverlaps();
+
+    for ( const auto * level_group : { level_group_a, level_group_b } )
+    {
+        TestTrue( TEXT( "Both groups of the cycle are reported" ), HasIssue( validator.GetLevelGroupIssues( level_group->GetPathName() ), EPLSValidationSeverity::Error, TEXT( "is part of a dependency cycle" ) ) );
+    }
+
+    TestEqual( TEXT( "Error count" ), validator.GetErrorCount(), 2 );
+
+    return true;
+}
+
+#endif
@@ -0,0 +1,359 @@
+#include "PLSRequest.h"
+#include "PLSSimulatedStreamingBackend.h"
+#include "PLSTypes.h"
+
+#include <Misc/AutomationTest.h>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    constexpr auto TestFlags = EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter;
+    constexpr auto TickDeltaTime = 0.01;
+    constexpr auto MaxTickCount = 10000;
+
+    FName GetLevelName( const TCHAR * name )
+    {
+        return FName( FString::Printf( TEXT( "/Game/PLSTests/%s" ), name ) );
+    }
+
+    FSoftObjectPath GetLevelPath( const TCHAR * name )
+    {
+        return FSoftObjectPath( FString::Printf( TEXT( "/Game/PLSTests/%s.%s" ), name, name ) );
+    }
+
+    FPLSLevelInstanceInfos MakeLevelInstanceInfos( const TCHAR * level_name, const TCHAR * instance_name )
+    {
+        FPLSLevelInstanceInfos infos;
+        infos.Level = TSoftObjectPtr< UWorld >( GetLevelPath( level_name ) );
+        infos.InstanceName = instance_name;
+        return infos;
+    }
+
+    FPLSLevelStreamingInfos MakeStreamingInfos( const FPLSLevelStreamingLevelInfos & levels_to_load, const FPLSLevelStreamingLevelInfos & levels_to_unload )
+    {
+        FPLSLevelStreamingInfos infos;
+        infos.UnloadCurrentStreamingLevelsInfos.bUnloadCurrentlyLoadedStreamingLevels = false;
+        infos.LevelsToLoad.AddDefaulted_GetRef().Levels = levels_to_load;
+        infos.LevelsToUnload.AddDefaulted_GetRef().Levels = levels_to_unload;
+        return infos;
+    }
+
+    struct FTestRequest
+    {
+        UPLSRequest * Request = nullptr;
+        TSharedRef< bool > bIsExecuted = MakeShared< bool >( false );
+    };
+
+    FTestRequest InitializeRequest( const TSharedRef< FPLSSimulatedStreamingBackend > & backend, const FPLSLevelStreamingInfos & infos )
+    {
+        FTestRequest test_request;
+        test_request.Request = NewObject< UPLSRequest >( GetTransientPackage() );
+        test_request.Request->Initialize( infos, backend, FPLSOnRequestExecutedDelegate::CreateLambda( [ is_executed = test_request.bIsExecuted ]( FPLSLevelStreamingRequestHandle /*handle*/ ) {
+            *is_executed = true;
+        } ) );
+        return test_request;
+    }
+
+    bool TickUntilExecuted( FPLSSimulatedStreamingBackend & backend, const FTestRequest & test_request )
+    {
+        for ( auto tick_index = 0; tick_index < MaxTickCount && !*test_request.bIsExecuted; ++tick_index )
+        {
+            backend.Tick( TickDeltaTime );
+        }
+
+        return *test_request.bIsExecuted;
+    }
+
+    bool RunRequest( FAutomationTestBase & test, const TSharedRef< FPLSSimulatedStreamingBackend > & backend, const FPLSLevelStreamingInfos & infos )
+    {
+        const auto test_request = InitializeRequest( backend, infos );
+        test_request.Request->Process();
+        return test.TestTrue( TEXT( "The request is executed" ), TickUntilExecuted( *backend, test_request ) );
+    }
+
+    TSharedRef< FPLSSimulatedStreamingBackend > MakeBackend( const TArray< const TCHAR * > & level_names )
+    {
+        const auto backend = MakeShared< FPLSSimulatedStreamingBackend >();
+        for ( const auto * level_name : level_names )
+        {
+            backend->AddLevel( GetLevelName( level_name ), FPLSSimulatedLevelSettings() );
+        }
+        return backend;
+    }
+
+    UPLSLevelGroup * MakeLevelGroup( const TArray< const TCHAR * > & level_names )
+    {
+        auto * level_group = NewObject< UPLSLevelGroup >( GetTransientPackage() );
+        for ( const auto * level_name : level_names )
+        {
+            level_group->Levels.Add( GetLevelPath( level_name ) );
+        }
+        return level_group;
+    }
+
+    void AddLevelDependency( UPLSLevelGroup & level_group, const TCHAR * level_name, const TArray< const TCHAR * > & prerequisite_names )
+    {
+        auto & level_dependency = level_group.LevelDependencies.AddDefaulted_GetRef();
+        level_dependency.Level = GetLevelPath( level_name );
+        for ( const auto * prerequisite_name : prerequisite_names )
+        {
+            level_dependency.Prerequisites.Add( GetLevelPath( prerequisite_name ) );
+        }
+    }
+
+    const FLoadLevelInfos & GetLoadLevelInfos( const FTestRequest & test_request, const TCHAR * level_name )
+    {
+        return test_request.Request->GetLevelsToLoad().FindChecked( GetLevelName( level_name ) );
+    }
+
+    FPLSLevelStreamingInfos MakeLevelGroupStreamingInfos( const TArray< UPLSLevelGroup * > & level_groups )
+    {
+        FPLSLevelStreamingLevelInfos levels_to_load;
+        levels_to_load.LevelGroups = level_groups;
+        return MakeStreamingInfos( levels_to_load, {} );
+    }
+
+    // Records the order in which the levels finish loading
+    struct FLoadOrderRecorder
+    {
+        explicit FLoadOrderRecorder( const TSharedRef< FPLSSimulatedStreamingBackend > & backend ) :
+            Backend( backend )
+        {
+            Handle = Backend->OnLevelStateChanged().AddLambda( [ this ]( const FName level ) {
+                if ( Backend->IsLevelLoaded( level ) )
+                {
+                    LoadedLevels.AddUnique( level );
+                }
+            } );
+        }
+
+        ~FLoadOrderRecorder()
+        {
+            Backend->OnLevelStateChanged().Remove( Handle );
+        }
+
+        int32 GetLoadIndex( const TCHAR * level_name ) const
+        {
+            return LoadedLevels.IndexOfByKey( GetLevelName( level_name ) );
+        }
+
+        TSharedRef< FPLSSimulatedStreamingBackend > Backend;
+        TArray< FName > LoadedLevels;
+        FDelegateHandle Handle;
+    };
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FPLSLevelInstancePoolingTest, "PortalLevelStreaming.Request.LevelInstances.Pooling", TestFlags )
+
+bool FPLSLevelInstancePoolingTest::RunTest( const FString & /*parameters*/ )
+{
+    const auto backend = MakeShared< FPLSSimulatedStreamingBackend >();
+    backend->AddLevel( GetLevelName( TEXT( "Room" ) ), FPLSSimulatedLevelSettings() );
+
+    FPLSLevelStreamingLevelInfos instance_levels;
+    instance_levels.LevelInstances.Add( MakeLevelInstanceInfos( TEXT( "Room" ), TEXT( "Room_1" ) ) );
+
+    RunRequest( *this, backend, MakeStreamingInfos( instance_levels, {} ) );
+    RunRequest( *this, backend, MakeStreamingInfos( {}, instance_levels ) );
+    RunRequest( *this, backend, MakeStreamingInfos( instance_levels, {} ) );
+
+    TestEqual( TEXT( "The unloaded instance is reused on the next visit" ), backend->GetCreatedLevelInstanceCount(), 1 );
+    TestTrue( TEXT( "The instance is visible" ), backend->IsLevelVisible( TEXT( "Room_1" ) ) );
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FPLSLevelInstanceEmptyPoolTest, "PortalLevelStreaming.Request.LevelInstances.EmptyPool", TestFlags )
+
+bool FPLSLevelInstanceEmptyPoolTest::RunTest( const FString & /*parameters*/ )
+{
+    // The instance is destroyed while the backend broadcasts its unloaded state
+    const auto backend = MakeShared< FPLSSimulatedStreamingBackend >();
+    backend->SetMaxPooledLevelInstances( 0 );
+    backend->AddLevel( GetLevelName( TEXT( "Room" ) ), FPLSSimulatedLevelSettings() );
+
+    FPLSLevelStreamingLevelInfos instance_levels;
+    instance_levels.LevelInstances.Add( MakeLevelInstanceInfos( TEXT( "Room" ), TEXT( "Room_1" ) ) );
+
+    RunRequest( *this, backend, MakeStreamingInfos( instance_levels, {} ) );
+    RunRequest( *this, backend, MakeStreamingInfos( {}, instance_levels ) );
+
+    TestFalse( TEXT( "The unloaded instance is destroyed" ), backend->IsLevelInstance( TEXT( "Room_1" ) ) );
+
+    RunRequest( *this, backend, MakeStreamingInfos( instance_levels, {} ) );
+
+    TestEqual( TEXT( "The instance is created again" ), backend->GetCreatedLevelInstanceCount(), 2 );
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FPLSLevelInstanceCancelTest, "PortalLevelStreaming.Request.LevelInstances.Cancel", TestFlags )
+
+bool FPLSLevelInstanceCancelTest::RunTest( const FString & /*parameters*/ )
+{
+    const auto backend = MakeShared< FPLSSimulatedStreamingBackend >();
+    backend->SetMaxPooledLevelInstances( 0 );
+    backend->AddLevel( GetLevelName( TEXT( "Room" ) ), FPLSSimulatedLevelSettings() );
+
+    FPLSLevelStreamingLevelInfos instance_levels;
+    instance_levels.LevelInstances.Add( MakeLevelInstanceInfos( TEXT( "Room" ), TEXT( "Room_1" ) ) );
+
+    // An instance held by a queued request must survive the cancellation of another request
+    const auto cancelled_request = InitializeRequest( backend, MakeStreamingInfos( instance_levels, {} ) );
+    const auto queued_request = InitializeRequest( backend, MakeStreamingInfos( instance_levels, {} ) );
+    cancelled_request.Request->Cancel();
+
+    TestTrue( TEXT( "The instance held by the queued request is kept" ), backend->IsLevelInstance( TEXT( "Room_1" ) ) );
+
+    // An instance cancelled while loading finishes loading and is not destroyed
+    queued_request.Request->Process();
+    backend->Tick( 0.0 );
+    queued_request.Request->Cancel();
+
+    for ( auto tick_index = 0; tick_index < 100; ++tick_index )
+    {
+        backend->Tick( TickDeltaTime );
+    }
+
+    TestTrue( TEXT( "The instance cancelled while loading is kept" ), backend->IsLevelInstance( TEXT( "Room_1" ) ) );
+    TestTrue( TEXT( "The instance cancelled while loading is loaded" ), backend->IsLevelLoaded( TEXT( "Room_1" ) ) );
+
+    // Once unloaded, nothing holds it anymore
+    RunRequest( *this, backend, MakeStreamingInfos( {}, instance_levels ) );
+
+    TestFalse( TEXT( "The unloaded instance is destroyed" ), backend->IsLevelInstance( TEXT( "Room_1" ) ) );
+    TestEqual( TEXT( "Only one instance was created" ), backend->GetCreatedLevelInstanceCount(), 1 );
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FPLSLevelInstanceNameCollisionTest, "PortalLevelStreaming.Request.LevelInstances.NameCollision", TestFlags )
+
+bool FPLSLevelInstanceNameCollisionTest::RunTest( const FString & /*parameters*/ )
+{
+    // Two levels with the same asset name in different folders, instantiated at the same transform
+    const auto backend = MakeShared< FPLSSimulatedStreamingBackend >();
+    backend->AddLevel( TEXT( "/Game/PLSTests/Castle/Room" ), FPLSSimulatedLevelSettings() );
+    backend->AddLevel( TEXT( "/Game/PLSTests/Dungeon/Room" ), FPLSSimulatedLevelSettings() );
+
+    FPLSLevelInstanceInfos castle_room;
+    castle_room.Level = TSoftObjectPtr< UWorld >( FSoftObjectPath( TEXT( "/Game/PLSTests/Castle/Room.Room" ) ) );
+
+    FPLSLevelInstanceInfos dungeon_room;
+    dungeon_room.Level = TSoftObjectPtr< UWorld >( FSoftObjectPath( TEXT( "/Game/PLSTests/Dungeon/Room.Room" ) ) );
+
+    TestTrue( TEXT( "The generated instance names are different" ), castle_room.GetInstanceName() != dungeon_room.GetInstanceName() );
+
+    FPLSLevelStreamingLevelInfos instance_levels;
+    instance_levels.LevelInstances = { castle_room, dungeon_room };
+    RunRequest( *this, backend, MakeStreamingInfos( instance_levels, {} ) );
+
+    TestEqual( TEXT( "Each level gets its own instance" ), backend->GetCreatedLevelInstanceCount(), 2 );
+    TestTrue( TEXT( "The instance of the castle room is visible" ), backend->IsLevelVisible( castle_room.GetInstanceName() ) );
+    TestTrue( TEXT( "The instance of the dungeon room is visible" ), backend->IsLevelVisible( dungeon_room.GetInstanceName() ) );
+
+    // An instance name given explicitly to another level must not hand out the existing instance
+    AddExpectedError( TEXT( "can not be used for" ), EAutomationExpectedErrorFlags::Contains, 1 );
+
+    dungeon_room.InstanceName = castle_room.GetInstanceName();
+
+    TestTrue( TEXT( "The instance of another level is not found" ), backend->FindLevelInstance( dungeon_room ).IsNone() );
+    TestTrue( TEXT( "The instance of another level is not acquired" ), backend->AcquireLevelInstance( dungeon_room ).IsNone() );
+    TestEqual( TEXT( "No instance is created for the colliding name" ), backend->GetCreatedLevelInstanceCount(), 2 );
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FPLSLevelDependencyWavesTest, "PortalLevelStreaming.Request.LevelDependencies.Waves", TestFlags )
+
+bool FPLSLevelDependencyWavesTest::RunTest( const FString & /*parameters*/ )
+{
+    const auto backend = MakeBackend( { TEXT( "A" ), TEXT( "B" ), TEXT( "C" ) } );
+    const FLoadOrderRecorder load_order( backend );
+
+    auto * level_group = MakeLevelGroup( { TEXT( "A" ), TEXT( "B" ), TEXT( "C" ) } );
+    AddLevelDependency( *level_group, TEXT( "C" ), { TEXT( "A" ), TEXT( "B" ) } );
+
+    const auto test_request = InitializeRequest( backend, MakeLevelGroupStreamingInfos( { level_group } ) );
+    test_request.Request->Process();
+
+    TestTrue( TEXT( "A starts with the first wave" ), GetLoadLevelInfos( test_request, TEXT( "A" ) ).bIsPending );
+    TestTrue( TEXT( "B starts with the first wave" ), GetLoadLevelInfos( test_request, TEXT( "B" ) ).bIsPending );
+    TestTrue( TEXT( "C waits for its prerequisites" ), GetLoadLevelInfos( test_request, TEXT( "C" ) ).bIsWaitingForPrerequisites );
+
+    if ( TestTrue( TEXT( "The request is executed" ), TickUntilExecuted( *backend, test_request ) ) )
+    {
+        TestTrue( TEXT( "C is loaded after A" ), load_order.GetLoadIndex( TEXT( "C" ) ) > load_order.GetLoadIndex( TEXT( "A" ) ) );
+        TestTrue( TEXT( "C is loaded after B" ), load_order.GetLoadIndex( TEXT( "C" ) ) > load_order.GetLoadIndex( TEXT( "B" ) ) );
+    }
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FPLSLevelDependencyLoadedPrerequisiteTest, "PortalLevelStreaming.Request.LevelDependencies.LoadedPrerequisite", TestFlags )
+
+bool FPLSLevelDependencyLoadedPrerequisiteTest::RunTest( const FString & /*parameters*/ )
+{
+    const auto backend = MakeBackend( { TEXT( "A" ), TEXT( "B" ) } );
+
+    FPLSLevelStreamingLevelInfos prerequisite_levels;
+    prerequisite_levels.IndividualLevels.Add( GetLevelPath( TEXT( "A" ) ) );
+    RunRequest( *this, backend, MakeStreamingInfos( prerequisite_levels, {} ) );
+
+    auto * level_group = MakeLevelGroup( { TEXT( "A" ), TEXT( "B" ) } );
+    AddLevelDependency( *level_group, TEXT( "B" ), { TEXT( "A" ) } );
+
+    const auto test_request = InitializeRequest( backend, MakeLevelGroupStreamingInfos( { level_group } ) );
+    test_request.Request->Process();
+
+    TestTrue( TEXT( "B does not wait for a prerequisite which is already loaded" ), GetLoadLevelInfos( test_request, TEXT( "B" ) ).bIsPending );
+    TestTrue( TEXT( "The request is executed" ), TickUntilExecuted( *backend, test_request ) );
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FPLSLevelDependencyCycleTest, "PortalLevelStreaming.Request.LevelDependencies.Cycle", TestFlags )
+
+bool FPLSLevelDependencyCycleTest::RunTest( const FString & /*parameters*/ )
+{
+    AddExpectedError( TEXT( "dependency cycle" ), EAutomationExpectedErrorFlags::Contains, 2 );
+
+    const auto backend = MakeBackend( { TEXT( "A" ), TEXT( "B" ), TEXT( "C" ) } );
+    const FLoadOrderRecorder load_order( backend );
+
+    // A and B depend on each other, C only depends on the cycle and must still wait for it
+    auto * level_group = MakeLevelGroup( { TEXT( "A" ), TEXT( "B" ), TEXT( "C" ) } );
+    AddLevelDependency( *level_group, TEXT( "A" ), { TEXT( "B" ) } );
+    AddLevelDependency( *level_group, TEXT( "B" ), { TEXT( "A" ) } );
+    AddLevelDependency( *level_group, TEXT( "C" ), { TEXT( "A" ) } );
+
+    const auto test_request = InitializeRequest( backend, MakeLevelGroupStreamingInfos( { level_group } ) );
+    test_request.Request->Process();
+
+    TestTrue( TEXT( "A starts although it is part of a cycle" ), GetLoadLevelInfos( test_request, TEXT( "A" ) ).bIsPending );
+    TestTrue( TEXT( "B starts although it is part of a cycle" ), GetLoadLevelInfos( test_request, TEXT( "B" ) ).bIsPending );
+    TestTrue( TEXT( "C keeps waiting for A" ), GetLoadLevelInfos( test_request, TEXT( "C" ) ).bIsWaitingForPrerequisites );
+
+    if ( TestTrue( TEXT( "The request is executed" ), TickUntilExecuted( *backend, test_request ) ) )
+    {
+        TestTrue( TEXT( "C is loaded after A" ), load_order.GetLoadIndex( TEXT( "C" ) ) > load_order.GetLoadIndex( TEXT( "A" ) ) );
+    }
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FPLSLevelDependencyNullGroupTest, "PortalLevelStreaming.Request.LevelDependencies.NullGroup", TestFlags )
+
+bool FPLSLevelDependencyNullGroupTest::RunTest( const FString & /*parameters*/ )
+{
+    const auto backend = MakeBackend( { TEXT( "A" ) } );
+
+    RunRequest( *this, backend, MakeLevelGroupStreamingInfos( { nullptr, MakeLevelGroup( { TEXT( "A" ) } ) } ) );
+
+    TestTrue( TEXT( "The levels of the valid group are loaded" ), backend->IsLevelVisible( GetLevelName( TEXT( "A" ) ) ) );
+
+    return true;
+}
+
+#endif
@@ -0,0 +1,134 @@
+#include "PLSRequest.h"
+#include "PLSSimulatedStreamingBackend.h"
+#include "PLSStreamingThrottle.h"
+#include "PLSTypes.h"
+
+#include <HAL/IConsoleManager.h>
+#include <Misc/AutomationTest.h>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// These tests expect the default values of the PLS.Throttle console variables
+
+namespace
+{
+    constexpr auto ThrottleTestFlags = EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter;
+    constexpr auto WithinBudgetFrameTime = 0.016f;
+    constexpr auto HitchFrameTime = 0.1f;
+    constexpr auto IOBacklog = 100;
+
+    FPLSLevelStreamingInfos MakeThrottleTestStreamingInfos( const TArray< const TCHAR * > & level_names )
+    {
+        FPLSLevelStreamingInfos infos;
+        infos.UnloadCurrentStreamingLevelsInfos.bUnloadCurrentlyLoadedStreamingLevels = false;
+
+        auto & levels_to_load = infos.LevelsToLoad.AddDefaulted_GetRef();
+        for ( const auto * level_name : level_names )
+        {
+            levels_to_load.Levels.IndividualLevels.Emplace( FString::Printf( TEXT( "/Game/PLSTests/%s.%s" ), level_name, level_name ) );
+        }
+
+        return infos;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FPLSStreamingThrottleUpdateTest, "PortalLevelStreaming.Throttle.Update", ThrottleTestFlags )
+
+bool FPLSStreamingThrottleUpdateTest::RunTest( const FString & /*parameters*/ )
+{
+    FPLSStreamingThrottle throttle;
+    TestEqual( TEXT( "The limit is lifted until the first update" ), throttle.GetMaxTransitionsPerTick(), MAX_int32 );
+
+    throttle.Update( WithinBudgetFrameTime, 0 );
+    TestEqual( TEXT( "The limit can not grow over PLS.Throttle.MaxTransitionsPerTick" ), throttle.GetMaxTransitionsPerTick(), 16 );
+
+    throttle.Update( WithinBudgetFrameTime, IOBacklog );
+    TestEqual( TEXT( "The limit is halved when the IO backlog is over budget" ), throttle.GetMaxTransitionsPerTick(), 8 );
+
+    throttle.Update( WithinBudgetFrameTime, 0 );
+    TestEqual( TEXT( "The limit is increased by one while the frames are within budget" ), throttle.GetMaxTransitionsPerTick(), 9 );
+
+    throttle.Update( HitchFrameTime, 0 );
+    TestEqual( TEXT( "The limit is halved by a hitch" ), throttle.GetMaxTransitionsPerTick(), 4 );
+
+    for ( auto index = 0; index < 4; ++index )
+    {
+        throttle.Update( HitchFrameTime, IOBacklog );
+    }
+    TestEqual( TEXT( "The limit can not go under PLS.Throttle.MinTransitionsPerTick" ), throttle.GetMaxTransitionsPerTick(), 1 );
+
+    throttle.SetBlockingAllowed( true );
+    throttle.Update( HitchFrameTime, IOBacklog );
+    TestEqual( TEXT( "The limit is lifted behind a loading screen" ), throttle.GetMaxTransitionsPerTick(), MAX_int32 );
+    TestTrue( TEXT( "The transitions are blocking behind a loading screen" ), throttle.ShouldBlock() );
+
+    auto * enabled_cvar = IConsoleManager::Get().FindConsoleVariable( TEXT( "PLS.Throttle.Enabled" ) );
+    enabled_cvar->Set( false, ECVF_SetByCode );
+    TestTrue( TEXT( "Disabling the throttle does not disable the blocking transitions" ), throttle.ShouldBlock() );
+    enabled_cvar->Set( true, ECVF_SetByCode );
+
+    throttle.SetBlockingAllowed( false );
+    TestFalse( TEXT( "The transitions are not blocking without a loading screen" ), throttle.ShouldBlock() );
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FPLSStreamingThrottleFrameBudgetTest, "PortalLevelStreaming.Throttle.FrameBudget", ThrottleTestFlags )
+
+bool FPLSStreamingThrottleFrameBudgetTest::RunTest( const FString & /*parameters*/ )
+{
+    constexpr uint64 Frame = 1;
+
+    FPLSStreamingThrottle throttle;
+    throttle.Update( WithinBudgetFrameTime, IOBacklog );
+    throttle.Update( WithinBudgetFrameTime, IOBacklog );
+    TestEqual( TEXT( "The limit is reduced by the IO backlog" ), throttle.GetMaxTransitionsPerTick(), 4 );
+
+    const auto backend = MakeShared< FPLSSimulatedStreamingBackend >();
+    for ( const auto * level_name : { TEXT( "A" ), TEXT( "B1" ), TEXT( "B2" ), TEXT( "B3" ), TEXT( "B4" ), TEXT( "B5" ) } )
+    {
+        backend->AddLevel( FName( FString::Printf( TEXT( "/Game/PLSTests/%s" ), level_name ) ), FPLSSimulatedLevelSettings() );
+    }
+
+    // Request A finishes in the middle of the frame, and gives back what it did not use of the budget
+    auto * request_a = NewObject< UPLSRequest >( GetTransientPackage() );
+    auto is_request_a_executed = false;
+    request_a->Initialize( MakeThrottleTestStreamingInfos( { TEXT( "A" ) } ), backend, FPLSOnRequestExecutedDelegate::CreateLambda( [ & ]( FPLSLevelStreamingRequestHandle /*handle*/ ) {
+        is_request_a_executed = true;
+        throttle.ReleaseFrameBudget( Frame, request_a->GetTransitionBudget() );
+    } ) );
+
+    request_a->SetTransitionBudget( throttle.AcquireFrameBudget( Frame ), false );
+    request_a->Process();
+
+    for ( auto tick_index = 0; tick_index < 1000 && !is_request_a_executed; ++tick_index )
+    {
+        backend->Tick( 0.01 );
+    }
+
+    if ( !TestTrue( TEXT( "Request A is executed" ), is_request_a_executed ) )
+    {
+        return false;
+    }
+
+    // Request B starts in the same frame, and only gets the leftover
+    auto * request_b = NewObject< UPLSRequest >( GetTransientPackage() );
+    request_b->Initialize( MakeThrottleTestStreamingInfos( { TEXT( "B1" ), TEXT( "B2" ), TEXT( "B3" ), TEXT( "B4" ), TEXT( "B5" ) } ), backend, FPLSOnRequestExecutedDelegate() );
+
+    TestTrue( TEXT( "The budget of the frame is acquired" ), throttle.IsFrameBudgetAcquired( Frame ) );
+    request_b->SetTransitionBudget( throttle.AcquireFrameBudget( Frame ), false );
+    request_b->Process();
+
+    TestEqual( TEXT( "Request B only starts the transitions request A did not use" ), backend->GetTransitioningLevelCount(), 3 );
+    TestEqual( TEXT( "Request B used all the budget of the frame" ), request_b->GetTransitionBudget(), 0 );
+
+    // The next frame has a whole budget again
+    TestFalse( TEXT( "The budget of the next frame is not acquired yet" ), throttle.IsFrameBudgetAcquired( Frame + 1 ) );
+    request_b->SetTransitionBudget( throttle.AcquireFrameBudget( Frame + 1 ), false );
+
+    TestEqual( TEXT( "Request B starts its last transitions in the next frame" ), backend->GetTransitioningLevelCount(), 5 );
+
+    return true;
+}
+
+#endif
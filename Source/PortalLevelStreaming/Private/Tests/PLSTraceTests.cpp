@@ -0,0 +1,172 @@
+#include "PLSTrace.h"
+
+#include <Misc/AutomationTest.h>
+#include <Misc/FileHelper.h>
+#include <Misc/Paths.h>
+#include <Serialization/MemoryWriter.h>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    constexpr auto TraceTestFlags = EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter;
+
+    // 'PLST'
+    constexpr uint32 TraceFileMagic = 0x54534C50;
+    constexpr uint32 TraceFileVersion = 1;
+
+    FString GetTracePath( const TCHAR * name )
+    {
+        return FPaths::Combine( FPaths::AutomationTransientDir(), TEXT( "PLSTraceTests" ), FString::Printf( TEXT( "%s.plstrace" ), name ) );
+    }
+
+    FPLSTrace MakeTrace()
+    {
+        FPLSTrace trace;
+
+        auto & request = trace.Requests.AddDefaulted_GetRef();
+        request.RequestHandle = 3;
+        request.Time = 1.5;
+        request.bCancelExistingRequests = true;
+        request.LoadOrder = EPLSLoadOrder::LoadThenUnload;
+
+        auto & level_to_load = request.LevelsToLoad.AddDefaulted_GetRef();
+        level_to_load.PackageName = TEXT( "/Game/PLSTests/Castle" );
+        level_to_load.bBlockOnLoad = true;
+        level_to_load.LoadType = EPLSLevelStreamingLoadType::Load;
+        level_to_load.Prerequisites.Add( TEXT( "/Game/PLSTests/Courtyard" ) );
+
+        auto & level_to_unload = request.LevelsToUnload.AddDefaulted_GetRef();
+        level_to_unload.PackageName = TEXT( "/Game/PLSTests/Courtyard" );
+        level_to_unload.UnloadType = EPLSLevelStreamingUnloadType::Hide;
+
+        auto & request_event = trace.Events.AddDefaulted_GetRef();
+        request_event.Time = 1.5;
+        request_event.Type = EPLSTraceEventType::RequestAdded;
+        request_event.RequestHandle = 3;
+
+        auto & level_event = trace.Events.AddDefaulted_GetRef();
+        level_event.Time = 2.25;
+        level_event.Type = EPLSTraceEventType::LevelStateChanged;
+        level_event.LevelPackageName = TEXT( "/Game/PLSTests/Castle" );
+        level_event.Param0 = 1;
+
+        return trace;
+    }
+
+    bool SaveHeader( const TCHAR * name, uint32 magic, uint32 version, const TOptional< int32 > & name_count )
+    {
+        TArray< uint8 > bytes;
+        FMemoryWriter writer( bytes );
+        writer << magic;
+        writer << version;
+
+        if ( name_count.IsSet() )
+        {
+            auto count = name_count.GetValue();
+            writer << count;
+        }
+
+        return FFileHelper::SaveArrayToFile( bytes, *GetTracePath( name ) );
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FPLSTraceRoundTripTest, "PortalLevelStreaming.Trace.RoundTrip", TraceTestFlags )
+
+bool FPLSTraceRoundTripTest::RunTest( const FString & /*parameters*/ )
+{
+    const auto saved_trace = MakeTrace();
+    if ( !TestTrue( TEXT( "The trace is saved" ), saved_trace.SaveToFile( GetTracePath( TEXT( "RoundTrip" ) ) ) ) )
+    {
+        return false;
+    }
+
+    FPLSTrace loaded_trace;
+    if ( !TestTrue( TEXT( "The trace is loaded" ), loaded_trace.LoadFromFile( GetTracePath( TEXT( "RoundTrip" ) ) ) ) )
+    {
+        return false;
+    }
+
+    if ( !TestEqual( TEXT( "The requests are loaded" ), loaded_trace.Requests.Num(), 1 ) || !TestEqual( TEXT( "The events are loaded" ), loaded_trace.Events.Num(), 2 ) )
+    {
+        return false;
+    }
+
+    const auto & request = loaded_trace.Requests[ 0 ];
+    TestEqual( TEXT( "Request handle" ), request.RequestHandle, 3 );
+    TestEqual( TEXT( "Request time" ), request.Time, 1.5, UE_DOUBLE_KINDA_SMALL_NUMBER );
+    TestTrue( TEXT( "Request cancels the existing requests" ), request.bCancelExistingRequests );
+    TestTrue( TEXT( "Request load order" ), request.LoadOrder == EPLSLoadOrder::LoadThenUnload );
+
+    if ( TestEqual( TEXT( "Levels to load" ), request.LevelsToLoad.Num(), 1 ) )
+    {
+        const auto & level = request.LevelsToLoad[ 0 ];
+        TestTrue( TEXT( "Level to load name" ), level.PackageName == TEXT( "/Game/PLSTests/Castle" ) );
+        TestTrue( TEXT( "Level to load blocks" ), level.bBlockOnLoad );
+        TestTrue( TEXT( "Level to load type" ), level.LoadType == EPLSLevelStreamingLoadType::Load );
+        TestTrue( TEXT( "Level to load prerequisites" ), level.Prerequisites.Num() == 1 && level.Prerequisites[ 0 ] == TEXT( "/Game/PLSTests/Courtyard" ) );
+    }
+
+    if ( TestEqual( TEXT( "Levels to unload" ), request.LevelsToUnload.Num(), 1 ) )
+    {
+        const auto & level = request.LevelsToUnload[ 0 ];
+        TestTrue( TEXT( "Level to unload name" ), level.PackageName == TEXT( "/Game/PLSTests/Courtyard" ) );
+        TestFalse( TEXT( "Level to unload blocks" ), level.bBlockOnUnload );
+        TestTrue( TEXT( "Level to unload type" ), level.UnloadType == EPLSLevelStreamingUnloadType::Hide );
+    }
+
+    const auto & level_event = loaded_trace.Events[ 1 ];
+    TestEqual( TEXT( "Event time" ), level_event.Time, 2.25, UE_DOUBLE_KINDA_SMALL_NUMBER );
+    TestTrue( TEXT( "Event type" ), level_event.Type == EPLSTraceEventType::LevelStateChanged );
+    TestEqual( TEXT( "Event request handle" ), level_event.RequestHandle, static_cast< int32 >( INDEX_NONE ) );
+    TestTrue( TEXT( "Event level" ), level_event.LevelPackageName == TEXT( "/Game/PLSTests/Castle" ) );
+    TestTrue( TEXT( "Event params" ), level_event.Param0 == 1 && level_event.Param1 == 0 );
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FPLSTraceInvalidHeaderTest, "PortalLevelStreaming.Trace.InvalidHeader", TraceTestFlags )
+
+bool FPLSTraceInvalidHeaderTest::RunTest( const FString & /*parameters*/ )
+{
+    AddExpectedError( TEXT( "Invalid portal level streaming trace" ), EAutomationExpectedErrorFlags::Contains, 2 );
+
+    FPLSTrace trace;
+
+    SaveHeader( TEXT( "WrongMagic" ), 0x12345678, TraceFileVersion, 0 );
+    TestFalse( TEXT( "A trace with a wrong magic is rejected" ), trace.LoadFromFile( GetTracePath( TEXT( "WrongMagic" ) ) ) );
+
+    SaveHeader( TEXT( "WrongVersion" ), TraceFileMagic, TraceFileVersion + 1, 0 );
+    TestFalse( TEXT( "A trace with a wrong version is rejected" ), trace.LoadFromFile( GetTracePath( TEXT( "WrongVersion" ) ) ) );
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FPLSTraceCorruptedTest, "PortalLevelStreaming.Trace.Corrupted", TraceTestFlags )
+
+bool FPLSTraceCorruptedTest::RunTest( const FString & /*parameters*/ )
+{
+    AddExpectedError( TEXT( "Corrupted portal level streaming trace" ), EAutomationExpectedErrorFlags::Contains, 2 );
+
+    FPLSTrace trace;
+
+    // The file ends before the size of the name table
+    SaveHeader( TEXT( "Truncated" ), TraceFileMagic, TraceFileVersion, {} );
+    TestFalse( TEXT( "A truncated trace is rejected" ), trace.LoadFromFile( GetTracePath( TEXT( "Truncated" ) ) ) );
+
+    // The name table claims more names than there are bytes left in the file
+    SaveHeader( TEXT( "OversizedCount" ), TraceFileMagic, TraceFileVersion, MAX_int32 );
+    TestFalse( TEXT( "A trace with an oversized count is rejected" ), trace.LoadFromFile( GetTracePath( TEXT( "OversizedCount" ) ) ) );
+
+    // The last event of a valid trace is cut short
+    TArray< uint8 > bytes;
+    MakeTrace().SaveToFile( GetTracePath( TEXT( "Valid" ) ) );
+    FFileHelper::LoadFileToArray( bytes, *GetTracePath( TEXT( "Valid" ) ) );
+    bytes.SetNum( bytes.Num() - 1 );
+    FFileHelper::SaveArrayToFile( bytes, *GetTracePath( TEXT( "TruncatedEvents" ) ) );
+    TestFalse( TEXT( "A trace missing its last byte is rejected" ), trace.LoadFromFile( GetTracePath( TEXT( "TruncatedEvents" ) ) ) );
+
+    return true;
+}
+
+#endif
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <CoreMinimal.h>
+
+#if WITH_EDITOR
+
+struct FPLSLevelStreamingInfos;
+class UPLSLevelGroup;
+
+enum class EPLSValidationSeverity : uint8
+{
+    Warning,
+    Error
+};
+
+struct FPLSValidationIssue
+{
+    EPLSValidationSeverity Severity;
+    FString Message;
+};
+
+// What a single FPLSLevelStreamingInfos (usually one portal transition) costs, and what is wrong with it
+struct FPLSStreamingInfosReport
+{
+    FString Owner;
+    TSet< FName > LevelsToLoad;
+    TSet< FName > LevelsToUnload;
+    int64 LoadSizeOnDisk = 0;
+    TArray< FPLSValidationIssue > Issues;
+    // Ratio of the levels to load which are also loaded by MaxOverlapOwner
+    float MaxOverlap = 0.0f;
+    FString MaxOverlapOwner;
+};
+
+/*
+ * Checks the streaming configs at author time : unresolvable or missing levels, duplicates, levels both loaded and unloaded...
+ * and estimates the cost of each transition : number of levels, size of the packages on disk and overlap with the other transitions.
+ */
+class PORTALLEVELSTREAMING_API FPLSConfigValidator
+{
+public:
+    // streaming_levels are the package names of the streaming levels of the world where infos is used. Pass nullptr when the world is not known
+    void ValidateStreamingInfos( const FString & owner, const FPLSLevelStreamingInfos & infos, const TSet< FName > * streaming_levels );
+    void ValidateLevelGroup( const UPLSLevelGroup & level_group );
+    // Must be called once all the infos and groups are validated. Can be called again after validating more of them
+    void ComputeOverlaps();
+
+    void LogReport() const;
+    bool SaveReport( const FString & file_path ) const;
+
+    int32 GetErrorCount() const;
+    int32 GetWarningCount() const;
+    const TArray< FPLSStreamingInfosReport > & GetReports() const;
+    // group_name is the path name of the group
+    TArray< FPLSValidationIssue > GetLevelGroupIssues( const FString & group_name ) const;
+
+    static void ValidateLevelGroup( const UPLSLevelGroup & level_group, TArray< FPLSValidationIssue > & issues );
+
+private:
+    static bool DoesLevelExist( FName package_name, int64 * size_on_disk = nullptr );
+
+    TArray< FPLSStreamingInfosReport > Reports;
+    TMap< FString, TArray< FPLSValidationIssue > > LevelGroupIssues;
+    // Which groups reference each level, to find the levels shared by several groups
+    TMap< FName, TArray< FString > > LevelToGroupsMap;
+    // Computed by ComputeOverlaps, apart from LevelGroupIssues so it can be computed again
+    TMap< FString, TArray< FPLSValidationIssue > > SharedLevelIssues;
+};
+
+FORCEINLINE const TArray< FPLSStreamingInfosReport > & FPLSConfigValidator::GetReports() const
+{
+    return Reports;
+}
+
+#endif
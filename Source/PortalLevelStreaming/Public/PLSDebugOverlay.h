@@ -0,0 +1,35 @@
+#pragma once
+
+#include <CoreMinimal.h>
+
+class APlayerController;
+class UCanvas;
+class UPLSSubsystem;
+
+struct FPLSDebugLine
+{
+    FString Text;
+    FColor Color;
+    // True for the levels which have been streaming for longer than PLS.Debug.StuckLevelTimeout
+    bool bIsStuck;
+};
+
+/*
+ * Draws the request queue of a UPLSSubsystem on top of the game viewport while PLS.Debug.Overlay is enabled,
+ * with the status and the elapsed time of each level of the executing request.
+ */
+class PORTALLEVELSTREAMING_API FPLSDebugOverlay
+{
+public:
+    explicit FPLSDebugOverlay( UPLSSubsystem & subsystem );
+    ~FPLSDebugOverlay();
+
+    // Describes the queue of subsystem. Also used by PLS.Requests.Dump to print it in the log
+    static void GetDebugLines( const UPLSSubsystem & subsystem, TArray< FPLSDebugLine > & lines );
+
+private:
+    void Draw( UCanvas * canvas, APlayerController * player_controller );
+
+    TWeakObjectPtr< UPLSSubsystem > Subsystem;
+    FDelegateHandle DrawDelegateHandle;
+};
@@ -1,13 +1,12 @@
 #pragma once
 
+#include "PLSStreamingBackend.h"
 #include "PLSTypes.h"
 
 #include <CoreMinimal.h>
 
 #include "PLSRequest.generated.h"
 
-class ULevelStreaming;
-
 USTRUCT( BlueprintType )
 struct FPLSLevelStreamingRequestHandle
 {
@@ -46,6 +45,11 @@ struct FPLSLevelStreamingRequestHandle
         return ::GetTypeHash( Handle.Handle );
     }
 
+    int32 GetValue() const
+    {
+        return Handle;
+    }
+
     FString ToString() const
     {
         return IsValid() ? FString::FromInt( Handle ) : TEXT( "Invalid" );
@@ -60,24 +64,56 @@ struct FUnloadLevelInfos
 {
     FUnloadLevelInfos( const uint8 block_on_unload, const EPLSLevelStreamingUnloadType unload_type ) :
         bBlockOnUnload( block_on_unload ),
-        UnloadType( unload_type )
+        bIsPending( false ),
+        bIsStuck( false ),
+        UnloadType( unload_type ),
+        RequestTime( 0.0 )
     {
     }
 
     uint8 bBlockOnUnload : 1;
+    // True while the request waits for the level to reach its unloaded or hidden state
+    uint8 bIsPending : 1;
+    // True once the level has been pending for longer than PLS.Debug.StuckLevelTimeout
+    uint8 bIsStuck : 1;
     EPLSLevelStreamingUnloadType UnloadType;
+    // Backend time when the transition was requested
+    double RequestTime;
 };
 
 struct FLoadLevelInfos
 {
     FLoadLevelInfos( const uint8 block_on_load, const EPLSLevelStreamingLoadType load_type ) :
         bBlockOnLoad( block_on_load ),
-        LoadType( load_type )
+        bIsPending( false ),
+        bIsWaitingForPrerequisites( false ),
+        bIsStuck( false ),
+        LoadType( load_type ),
+        RequestTime( 0.0 )
     {
     }
 
     uint8 bBlockOnLoad : 1;
+    // True while the request waits for the level to reach its loaded or visible state
+    uint8 bIsPending : 1;
+    // True while the level can not start loading because some of its prerequisites are not loaded yet
+    uint8 bIsWaitingForPrerequisites : 1;
+    // True once the level has been pending for longer than PLS.Debug.StuckLevelTimeout
+    uint8 bIsStuck : 1;
     EPLSLevelStreamingLoadType LoadType;
+    // Backend time when the transition was requested
+    double RequestTime;
+    // Levels of the same request which must reach their loaded state before this one starts loading
+    TArray< FName > Prerequisites;
+};
+
+enum class EPLSLevelRequestStatus : uint8
+{
+    Queued,
+    WaitingForPrerequisites,
+    WaitingForBudget,
+    Streaming,
+    Done
 };
 
 DECLARE_DELEGATE_OneParam( FPLSOnRequestExecutedDelegate, FPLSLevelStreamingRequestHandle handle );
@@ -91,33 +127,74 @@ class UPLSRequest : public UObject
 public:
     FPLSLevelStreamingRequestHandle GetHandle() const;
     bool IsExecuting() const;
-
-    void Initialize( const FPLSLevelStreamingInfos & infos, const FPLSOnRequestExecutedDelegate & on_request_executed );
+    EPLSLoadOrder GetLoadOrder() const;
+    const TMap< FName, FUnloadLevelInfos > & GetLevelsToUnload() const;
+    const TMap< FName, FLoadLevelInfos > & GetLevelsToLoad() const;
+    int32 GetLevelToUnloadCount() const;
+    int32 GetLevelToLoadCount() const;
+    // Backend time when the request started to be processed
+    double GetProcessStartTime() const;
+    EPLSLevelRequestStatus GetLevelStatus( FName level ) const;
+
+    void Initialize( const FPLSLevelStreamingInfos & infos, const TSharedRef< IPLSStreamingBackend > & backend, const FPLSOnRequestExecutedDelegate & on_request_executed );
     void Cancel();
     void Process();
+
+    // Sets how many level transitions can still be started until the next call, and starts the levels which were waiting for some budget
+    void SetTransitionBudget( int32 transition_budget, bool force_blocking_transitions );
+    int32 GetTransitionBudget() const;
     UWorld * GetWorld() const override;
 
+    // Stops waiting for the levels of the current step, as if they had all reached their requested state, so a stalled request lets the queue move on.
+    // The levels which were already requested keep streaming in the backend
+    void SkipPendingLevels();
+
+    // Logs a warning for each level which has been streaming for longer than timeout seconds. Each level is only reported once
+    void ReportStuckLevels( double timeout );
+
 private:
-    ULevelStreaming * FindLevelStreaming( const FSoftObjectPath & soft_object_path ) const;
     void UnloadLevels( bool load_levels_when_finished );
     void LoadLevels( bool unload_levels_when_finished );
-
-    UFUNCTION()
-    void OnLevelStreamingUnloaded();
-
-    UFUNCTION()
-    void OnLevelStreamingLoadedOrVisible();
-
-    void BroadcastExecutedEvent() const;
-    void UnbindLevelStreamingEvents() const;
-
-    TMap< ULevelStreaming *, FUnloadLevelInfos > LevelsToUnloadMap;
-    TMap< ULevelStreaming *, FLoadLevelInfos > LevelsToLoadMap;
+    bool HasReachedUnloadedState( FName level, const FUnloadLevelInfos & infos ) const;
+    bool HasReachedLoadedState( FName level, const FLoadLevelInfos & infos ) const;
+    void ReleaseAcquiredLevelInstances();
+    void AddLevelGroupToLoad( const UPLSLevelGroup * level_group, const FPLSLevelStreamingLevelToLoadInfos & levels_to_load, TMap< const UPLSLevelGroup *, TArray< FName > > & loaded_groups );
+    void AddLoadPrerequisite( FName level, FName prerequisite );
+    void RemoveLoadPrerequisiteCycles();
+    bool ArePrerequisitesLoaded( const FLoadLevelInfos & infos ) const;
+    void LoadLevel( FName level, FLoadLevelInfos & infos );
+    void UnloadLevel( FName level, FUnloadLevelInfos & infos );
+    bool ConsumeTransitionBudget( FName level );
+    void LoadLevelsWithLoadedPrerequisites();
+
+    void OnLevelStateChanged( FName level );
+    void OnLevelUnloaded();
+    void OnLevelLoaded();
+    // Moves on to the next step once no level of the current one is left to wait for
+    void FinishUnloadStep();
+    void FinishLoadStep();
+
+    void RecordLevelRequested( FName level, bool should_be_loaded, bool should_be_visible ) const;
+    void BroadcastExecutedEvent();
+    void UnbindLevelStreamingEvents();
+
+    TMap< FName, FUnloadLevelInfos > LevelsToUnloadMap;
+    TMap< FName, FLoadLevelInfos > LevelsToLoadMap;
+    // One entry for each AcquireLevelInstance call, released when the request is executed or cancelled
+    TArray< FName > AcquiredLevelInstances;
+    // Levels which are ready to transition but wait for the throttle to give some budget to the request
+    TArray< FName > LevelsWaitingForBudget;
     int LevelToUnloadCount;
     int LevelToLoadCount;
+    int LevelWaitingForPrerequisitesCount;
+    int32 TransitionBudget;
+    bool bForceBlockingTransitions;
+    double ProcessStartTime;
     EPLSLoadOrder LoadOrder;
     FPLSLevelStreamingRequestHandle Handle;
     FPLSOnRequestExecutedDelegate OnRequestExecutedDelegate;
+    TSharedPtr< IPLSStreamingBackend > Backend;
+    FDelegateHandle LevelStateChangedHandle;
 };
 
 FORCEINLINE FPLSLevelStreamingRequestHandle UPLSRequest::GetHandle() const
@@ -128,4 +205,39 @@ FORCEINLINE FPLSLevelStreamingRequestHandle UPLSRequest::GetHandle() const
 FORCEINLINE bool UPLSRequest::IsExecuting() const
 {
     return LevelToLoadCount + LevelToUnloadCount > 0;
+}
+
+FORCEINLINE EPLSLoadOrder UPLSRequest::GetLoadOrder() const
+{
+    return LoadOrder;
+}
+
+FORCEINLINE const TMap< FName, FUnloadLevelInfos > & UPLSRequest::GetLevelsToUnload() const
+{
+    return LevelsToUnloadMap;
+}
+
+FORCEINLINE const TMap< FName, FLoadLevelInfos > & UPLSRequest::GetLevelsToLoad() const
+{
+    return LevelsToLoadMap;
+}
+
+FORCEINLINE int32 UPLSRequest::GetTransitionBudget() const
+{
+    return TransitionBudget;
+}
+
+FORCEINLINE int32 UPLSRequest::GetLevelToUnloadCount() const
+{
+    return LevelToUnloadCount;
+}
+
+FORCEINLINE int32 UPLSRequest::GetLevelToLoadCount() const
+{
+    return LevelToLoadCount;
+}
+
+FORCEINLINE double UPLSRequest::GetProcessStartTime() const
+{
+    return ProcessStartTime;
 }
\ No newline at end of file
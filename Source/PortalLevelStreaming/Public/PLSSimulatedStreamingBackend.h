@@ -0,0 +1,129 @@
+#pragma once
+
+#include "PLSStreamingBackend.h"
+
+#include <CoreMinimal.h>
+
+struct FPLSSimulatedLevelSettings
+{
+    // Time spent in IO to load the level. IO is serialized : a level starts loading when the previous one is done
+    double LoadLatency = 0.1;
+    // Time to add a loaded level to the world, or to remove it
+    double VisibilityLatency = 0.016;
+    int64 MemoryCost = 0;
+    bool bAlwaysLoaded = false;
+};
+
+/*
+ * Streaming backend without any content, which models the IO latency and the memory cost of each level.
+ * Time only advances when Tick is called, so a simulation is fully deterministic for a given random seed.
+ */
+class PORTALLEVELSTREAMING_API FPLSSimulatedStreamingBackend final : public IPLSStreamingBackend
+{
+public:
+    explicit FPLSSimulatedStreamingBackend( int32 random_seed = 0, float latency_jitter = 0.0f );
+
+    void AddLevel( FName level, const FPLSSimulatedLevelSettings & settings );
+    void SetMaxPooledLevelInstances( int32 max_pooled_level_instances );
+    void Tick( double delta_seconds );
+
+    int64 GetMemoryUsage() const;
+    int64 GetPeakMemoryUsage() const;
+    // Accumulated time of the blocking loads and unloads, which would have been hitches in a real session
+    double GetBlockingTime() const;
+    int32 GetTransitioningLevelCount() const;
+    // Number of level instances which had to be created because none could be reused from the pool
+    int32 GetCreatedLevelInstanceCount() const;
+
+    FName FindLevel( const FSoftObjectPath & soft_object_path ) const override;
+    void GetLevels( TArray< FName > & levels ) const override;
+    bool IsLevelLoaded( FName level ) const override;
+    bool IsLevelVisible( FName level ) const override;
+    bool IsLevelAlwaysLoaded( FName level ) const override;
+    void RequestLevelLoad( FName level, bool make_visible, bool block_on_load ) override;
+    void RequestLevelUnload( FName level, bool unload, bool block_on_unload ) override;
+    double GetTimeSeconds() const override;
+    int32 GetPendingLoadCount() const override;
+
+protected:
+    FName CreateLevelInstance( const FPLSLevelInstanceInfos & infos, FName instance_name ) override;
+    void DestroyLevelInstance( FName level ) override;
+    bool DoesLevelExist( FName level ) const override;
+    bool ShouldLevelBeLoaded( FName level ) const override;
+    int32 GetMaxPooledLevelInstances() const override;
+
+private:
+    enum class ELevelState : uint8
+    {
+        Unloaded,
+        Loading,
+        LoadedNotVisible,
+        MakingVisible,
+        LoadedVisible,
+        MakingInvisible
+    };
+
+    struct FLevel
+    {
+        FPLSSimulatedLevelSettings Settings;
+        ELevelState State = ELevelState::Unloaded;
+        double TransitionEndTime = 0.0;
+        bool bShouldBeLoaded = false;
+        bool bShouldBeVisible = false;
+        bool bShouldBlock = false;
+    };
+
+    enum class EAdvanceResult : uint8
+    {
+        // The level waits for the end of its current transition
+        Transitioning,
+        // The level reached its requested state
+        Idle,
+        TransitionStarted,
+        // The level finished a transition, which must be broadcast
+        StateChanged
+    };
+
+    // Advances the state of the level as far as the current time allows. Returns false when the level reached its requested state
+    bool UpdateLevel( FName level_name );
+    EAdvanceResult AdvanceLevel( FLevel & level );
+    double GetLatency( double latency );
+
+    TMap< FName, FLevel > Levels;
+    // Only the levels which did not reach their requested state are updated each tick
+    TSet< FName > TransitioningLevels;
+    FRandomStream RandomStream;
+    float LatencyJitter;
+    double Time;
+    double IOBusyUntilTime;
+    double BlockingTime;
+    int64 MemoryUsage;
+    int64 PeakMemoryUsage;
+    int32 MaxPooledLevelInstances;
+    int32 CreatedLevelInstanceCount;
+};
+
+FORCEINLINE int64 FPLSSimulatedStreamingBackend::GetMemoryUsage() const
+{
+    return MemoryUsage;
+}
+
+FORCEINLINE int64 FPLSSimulatedStreamingBackend::GetPeakMemoryUsage() const
+{
+    return PeakMemoryUsage;
+}
+
+FORCEINLINE double FPLSSimulatedStreamingBackend::GetBlockingTime() const
+{
+    return BlockingTime;
+}
+
+FORCEINLINE int32 FPLSSimulatedStreamingBackend::GetTransitioningLevelCount() const
+{
+    return TransitioningLevels.Num();
+}
+
+FORCEINLINE int32 FPLSSimulatedStreamingBackend::GetCreatedLevelInstanceCount() const
+{
+    return CreatedLevelInstanceCount;
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <CoreMinimal.h>
+#include <UObject/SoftObjectPath.h>
+
+struct FPLSLevelInstanceInfos;
+class ULevel;
+class ULevelStreaming;
+enum class ELevelStreamingState : uint8;
+
+DECLARE_MULTICAST_DELEGATE_OneParam( FPLSOnBackendLevelStateChangedDelegate, FName level );
+
+/*
+ * What the requests use to drive the streaming levels. Levels are identified by their package name.
+ * The default implementation works on the ULevelStreaming of a world, other implementations can simulate the streaming without any content.
+ * The reference counting and the pooling of the level instances are shared by all the implementations, which only create and destroy the instances.
+ */
+class PORTALLEVELSTREAMING_API IPLSStreamingBackend
+{
+public:
+    virtual ~IPLSStreamingBackend() = default;
+
+    // Returns the name of the level referenced by soft_object_path, or NAME_None if the backend does not know it
+    virtual FName FindLevel( const FSoftObjectPath & soft_object_path ) const = 0;
+    virtual void GetLevels( TArray< FName > & levels ) const = 0;
+    virtual bool IsLevelLoaded( FName level ) const = 0;
+    virtual bool IsLevelVisible( FName level ) const = 0;
+    virtual bool IsLevelAlwaysLoaded( FName level ) const = 0;
+    virtual void RequestLevelLoad( FName level, bool make_visible, bool block_on_load ) = 0;
+    virtual void RequestLevelUnload( FName level, bool unload, bool block_on_unload ) = 0;
+    virtual double GetTimeSeconds() const = 0;
+    // Number of loads still in flight, used to throttle the requests when the IO is saturated
+    virtual int32 GetPendingLoadCount() const = 0;
+
+    // Returns the level of the instance described by infos, creating it unloaded if it does not exist yet.
+    // NAME_None if it could not be created, or if the instance name is already used by an instance of another level.
+    // Each successful call must be balanced by a call to ReleaseLevelInstance
+    FName AcquireLevelInstance( const FPLSLevelInstanceInfos & infos );
+    // Returns the level of an existing instance, or NAME_None
+    FName FindLevelInstance( const FPLSLevelInstanceInfos & infos ) const;
+    bool IsLevelInstance( FName level ) const;
+    // Releases a reference taken with AcquireLevelInstance. Once no request holds an instance and it is unloaded,
+    // the backend keeps it for a later visit, or destroys it when too many are pooled
+    void ReleaseLevelInstance( FName level );
+
+    // Broadcast each time a level finished a transition : loaded, made visible, hidden or unloaded
+    FPLSOnBackendLevelStateChangedDelegate & OnLevelStateChanged();
+
+protected:
+    // Creates the level of a new instance, unloaded. Returns NAME_None if it could not be created
+    virtual FName CreateLevelInstance( const FPLSLevelInstanceInfos & infos, FName instance_name ) = 0;
+    // Removes an unloaded instance evicted from the pool
+    virtual void DestroyLevelInstance( FName level ) = 0;
+    // False once the level of an instance was removed by something else than the backend
+    virtual bool DoesLevelExist( FName level ) const = 0;
+    // True while the level is loaded, or requested to be loaded
+    virtual bool ShouldLevelBeLoaded( FName level ) const = 0;
+    virtual int32 GetMaxPooledLevelInstances() const = 0;
+
+    // Broadcasts the new state of the level, then pools it if it is an instance nobody uses anymore.
+    // The listeners can acquire, release and destroy levels
+    void BroadcastLevelStateChanged( FName level );
+
+    FPLSOnBackendLevelStateChangedDelegate OnLevelStateChangedDelegate;
+
+private:
+    struct FLevelInstance
+    {
+        FName InstanceName;
+        // Level the instance was created from, to refuse to hand it out for another level with the same instance name
+        FSoftObjectPath SourceLevel;
+        // Number of AcquireLevelInstance calls not balanced by ReleaseLevelInstance yet
+        int32 AcquireCount;
+    };
+
+    // Pools the instance when no request holds it anymore and it is unloaded, and destroys the oldest pooled instances above the limit
+    void PoolLevelInstanceIfUnused( FName level );
+    void RemoveLevelInstance( FName level );
+
+    TMap< FName, FLevelInstance > LevelInstances;
+    TMap< FName, FName > InstanceNameToLevelMap;
+    // Released instances, least recently used first
+    TArray< FName > PooledLevelInstances;
+};
+
+FORCEINLINE FPLSOnBackendLevelStateChangedDelegate & IPLSStreamingBackend::OnLevelStateChanged()
+{
+    return OnLevelStateChangedDelegate;
+}
+
+// Drives the ULevelStreaming objects of a world
+class PORTALLEVELSTREAMING_API FPLSLevelStreamingBackend final : public IPLSStreamingBackend
+{
+public:
+    explicit FPLSLevelStreamingBackend( UWorld * world );
+    ~FPLSLevelStreamingBackend() override;
+
+    FName FindLevel( const FSoftObjectPath & soft_object_path ) const override;
+    void GetLevels( TArray< FName > & levels ) const override;
+    bool IsLevelLoaded( FName level ) const override;
+    bool IsLevelVisible( FName level ) const override;
+    bool IsLevelAlwaysLoaded( FName level ) const override;
+    void RequestLevelLoad( FName level, bool make_visible, bool block_on_load ) override;
+    void RequestLevelUnload( FName level, bool unload, bool block_on_unload ) override;
+    double GetTimeSeconds() const override;
+    int32 GetPendingLoadCount() const override;
+
+    ULevelStreaming * GetLevelStreaming( FName level ) const;
+
+    // FindLevel matches the streaming levels like the engine's LoadStreamLevel : the package name of the streaming level must end with the safe name of the level.
+    // world adds the prefix of the PIE levels to the safe name, and can be null outside of a game, for example to validate the configs
+    static FString MakeSafeLevelName( const FSoftObjectPath & soft_object_path, UWorld * world );
+    static bool IsMatchingStreamingLevel( const FString & streaming_level_package_name, const FString & safe_level_name );
+
+protected:
+    FName CreateLevelInstance( const FPLSLevelInstanceInfos & infos, FName instance_name ) override;
+    void DestroyLevelInstance( FName level ) override;
+    bool DoesLevelExist( FName level ) const override;
+    bool ShouldLevelBeLoaded( FName level ) const override;
+    int32 GetMaxPooledLevelInstances() const override;
+
+private:
+    void NotifyPlayerControllers( ULevelStreaming * level_streaming, bool should_be_loaded, bool should_be_visible, bool should_block ) const;
+    void OnLevelStreamingStateChanged( UWorld * world, const ULevelStreaming * level_streaming, ULevel * level_if_loaded, ELevelStreamingState previous_state, ELevelStreamingState new_state );
+
+    TWeakObjectPtr< UWorld > WorldPtr;
+    // Avoids scanning all the streaming levels of the world each time a level is queried
+    mutable TMap< FName, TWeakObjectPtr< ULevelStreaming > > LevelStreamingCache;
+    FDelegateHandle LevelStreamingStateChangedHandle;
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <CoreMinimal.h>
+
+/*
+ * Decides how many level transitions the executing request can start each tick, from the measured frame time and the amount of async loading still in flight.
+ * The limit is increased by one while the frames are within budget, and halved as soon as a frame or the IO backlog goes over it.
+ * Behind a loading screen, hitches are not visible : the limit is lifted and the transitions are escalated to blocking ones.
+ * The throttle never escalates on its own : only UPLSSubsystem::SetLoadingScreenVisible allows blocking transitions.
+ */
+class PORTALLEVELSTREAMING_API FPLSStreamingThrottle
+{
+public:
+    FPLSStreamingThrottle();
+
+    void Update( float delta_seconds, int32 pending_load_count );
+    void SetBlockingAllowed( bool is_blocking_allowed );
+
+    // The requests which start during the same frame share its budget : the first one gets the whole limit, the next ones only what the previous ones left
+    int32 AcquireFrameBudget( uint64 frame );
+    void ReleaseFrameBudget( uint64 frame, int32 remaining_budget );
+    bool IsFrameBudgetAcquired( uint64 frame ) const;
+
+    int32 GetMaxTransitionsPerTick() const;
+    bool ShouldBlock() const;
+    float GetAverageFrameTime() const;
+
+private:
+    float AverageFrameTime;
+    int32 MaxTransitionsPerTick;
+    bool bIsBlockingAllowed;
+    uint64 FrameBudgetFrame;
+    int32 RemainingFrameBudget;
+};
+
+FORCEINLINE int32 FPLSStreamingThrottle::GetMaxTransitionsPerTick() const
+{
+    return MaxTransitionsPerTick;
+}
+
+FORCEINLINE float FPLSStreamingThrottle::GetAverageFrameTime() const
+{
+    return AverageFrameTime;
+}
+
+FORCEINLINE bool FPLSStreamingThrottle::ShouldBlock() const
+{
+    return bIsBlockingAllowed;
+}
+
+FORCEINLINE bool FPLSStreamingThrottle::IsFrameBudgetAcquired( const uint64 frame ) const
+{
+    return FrameBudgetFrame == frame;
+}
@@ -1,6 +1,9 @@
 #pragma once
 
+#include "PLSDebugOverlay.h"
 #include "PLSRequest.h"
+#include "PLSStreamingThrottle.h"
+#include "PLSTrace.h"
 
 #include <CoreMinimal.h>
 #include <Subsystems/WorldSubsystem.h>
@@ -15,7 +18,7 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam( FPLSOnRequestExecutedDynamicMultica
 DECLARE_MULTICAST_DELEGATE( FPLSOnAllRequestsFinishedDelegate );
 
 UCLASS()
-class PORTALLEVELSTREAMING_API UPLSSubsystem final : public UWorldSubsystem
+class PORTALLEVELSTREAMING_API UPLSSubsystem final : public UTickableWorldSubsystem
 {
     GENERATED_BODY()
 
@@ -31,9 +34,40 @@ public:
 
     void CallOrRegister_OnAllRequestsFinished( FPLSOnAllRequestsFinishedDelegate::FDelegate delegate );
 
+    // The first request is the executing one, the others are queued
+    const TArray< UPLSRequest * > & GetRequests() const;
+
+    // Removes the request from the queue without calling its executed delegate. Returns false if the request is not queued
+    bool CancelRequest( FPLSLevelStreamingRequestHandle request_handle );
+
+    void Initialize( FSubsystemCollectionBase & collection ) override;
+    void Deinitialize() override;
+    void Tick( float delta_time ) override;
+    TStatId GetStatId() const override;
+
+    // While a loading screen hides the hitches, the transitions are not throttled anymore and are escalated to blocking ones
+    UFUNCTION( BlueprintCallable )
+    void SetLoadingScreenVisible( bool is_visible );
+
+    const FPLSStreamingThrottle & GetThrottle() const;
+
+    // Replaces the backend used by the requests, for example with a simulated one to profile the scheduling offline. Must be called while no request is queued, and before starting a trace recording
+    void SetBackend( const TSharedRef< IPLSStreamingBackend > & backend );
+    TSharedPtr< IPLSStreamingBackend > GetBackend() const;
+
+    // Starts recording the requests and the level state transitions of this world into a trace which can be replayed offline
+    void StartTraceRecording();
+
+    // Stops the recording and writes the trace to file_path. Returns false if nothing was recorded or the file could not be written
+    bool StopTraceRecording( const FString & file_path );
+
+    FPLSTraceRecorder * GetTraceRecorder() const;
+
 private:
     void OnRequestExecuted( FPLSLevelStreamingRequestHandle handle );
     void ProcessNextRequest();
+    // Gives back what is left of the budget of the frame when the executing request ends, so the next one can not start more transitions than the throttle allows
+    void ReleaseTransitionBudget( const UPLSRequest & request );
 
     UPROPERTY()
     TArray< UPLSRequest * > Requests;
@@ -41,9 +75,33 @@ private:
     TMap< FPLSLevelStreamingRequestHandle, FPLSLevelStreamingInfos > RequestHandleToInfosMap;
     FPLSOnRequestExecutedDynamicMulticastDelegate OnRequestExecutedDelegate;
     FPLSOnAllRequestsFinishedDelegate OnAllRequestsFinishedDelegate;
+    TSharedPtr< IPLSStreamingBackend > Backend;
+    TUniquePtr< FPLSTraceRecorder > TraceRecorder;
+    FPLSStreamingThrottle Throttle;
+    TUniquePtr< FPLSDebugOverlay > DebugOverlay;
 };
 
 FORCEINLINE FPLSOnRequestExecutedDynamicMulticastDelegate & UPLSSubsystem::OnRequestExecuted()
 {
     return OnRequestExecutedDelegate;
+}
+
+FORCEINLINE const TArray< UPLSRequest * > & UPLSSubsystem::GetRequests() const
+{
+    return Requests;
+}
+
+FORCEINLINE TSharedPtr< IPLSStreamingBackend > UPLSSubsystem::GetBackend() const
+{
+    return Backend;
+}
+
+FORCEINLINE const FPLSStreamingThrottle & UPLSSubsystem::GetThrottle() const
+{
+    return Throttle;
+}
+
+FORCEINLINE FPLSTraceRecorder * UPLSSubsystem::GetTraceRecorder() const
+{
+    return TraceRecorder.Get();
 }
\ No newline at end of file
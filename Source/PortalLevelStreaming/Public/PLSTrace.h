@@ -0,0 +1,104 @@
+#pragma once
+
+#include "PLSRequest.h"
+
+#include <CoreMinimal.h>
+
+enum class EPLSTraceEventType : uint8
+{
+    RequestAdded,
+    RequestCancelled,
+    RequestStarted,
+    RequestExecuted,
+    // A request asked a level to change its state. Param0 / Param1 are ShouldBeLoaded / ShouldBeVisible
+    LevelRequested,
+    // The streaming backend reported a level transition. Param0 / Param1 are IsLevelLoaded / IsLevelVisible after the transition
+    LevelStateChanged
+};
+
+struct FPLSTraceEvent
+{
+    FPLSTraceEvent() :
+        Time( 0.0 ),
+        Type( EPLSTraceEventType::RequestAdded ),
+        RequestHandle( INDEX_NONE ),
+        Param0( 0 ),
+        Param1( 0 )
+    {
+    }
+
+    double Time;
+    EPLSTraceEventType Type;
+    int32 RequestHandle;
+    FName LevelPackageName;
+    uint8 Param0;
+    uint8 Param1;
+};
+
+struct FPLSTraceLevelToLoad
+{
+    FName PackageName;
+    bool bBlockOnLoad = false;
+    EPLSLevelStreamingLoadType LoadType = EPLSLevelStreamingLoadType::LoadAndMakeVisible;
+    TArray< FName > Prerequisites;
+};
+
+struct FPLSTraceLevelToUnload
+{
+    FName PackageName;
+    bool bBlockOnUnload = false;
+    EPLSLevelStreamingUnloadType UnloadType = EPLSLevelStreamingUnloadType::HideAndUnload;
+};
+
+// The levels a request resolved when it was added, so it can be replayed without the original infos or content
+struct FPLSTraceRequest
+{
+    int32 RequestHandle = INDEX_NONE;
+    double Time = 0.0;
+    bool bCancelExistingRequests = false;
+    EPLSLoadOrder LoadOrder = EPLSLoadOrder::UnloadThenLoad;
+    TArray< FPLSTraceLevelToLoad > LevelsToLoad;
+    TArray< FPLSTraceLevelToUnload > LevelsToUnload;
+};
+
+class PORTALLEVELSTREAMING_API FPLSTrace
+{
+public:
+    bool SaveToFile( const FString & file_path ) const;
+    bool LoadFromFile( const FString & file_path );
+    void Reset();
+
+    TArray< FPLSTraceRequest > Requests;
+    TArray< FPLSTraceEvent > Events;
+
+private:
+    bool Serialize( FArchive & archive );
+};
+
+// Records the streaming requests and the state transitions of the levels of a streaming backend into a FPLSTrace
+class PORTALLEVELSTREAMING_API FPLSTraceRecorder
+{
+public:
+    explicit FPLSTraceRecorder( const TSharedRef< IPLSStreamingBackend > & backend );
+    ~FPLSTraceRecorder();
+
+    const FPLSTrace & GetTrace() const;
+
+    void RecordRequestAdded( const UPLSRequest & request, bool cancel_existing_requests );
+    void RecordRequestEvent( EPLSTraceEventType event_type, FPLSLevelStreamingRequestHandle handle );
+    void RecordLevelRequested( FPLSLevelStreamingRequestHandle handle, FName level_package_name, bool should_be_loaded, bool should_be_visible );
+
+private:
+    double GetTime() const;
+    void OnLevelStateChanged( FName level );
+
+    TSharedRef< IPLSStreamingBackend > Backend;
+    FPLSTrace Trace;
+    double StartTime;
+    FDelegateHandle LevelStateChangedHandle;
+};
+
+FORCEINLINE const FPLSTrace & FPLSTraceRecorder::GetTrace() const
+{
+    return Trace;
+}
@@ -5,14 +5,39 @@
 
 #include "PLSTypes.generated.h"
 
+// A level of a group which must wait for other levels of the same group before being loaded
+USTRUCT( BlueprintType )
+struct PORTALLEVELSTREAMING_API FPLSLevelDependency
+{
+    GENERATED_USTRUCT_BODY()
+
+    UPROPERTY( EditAnywhere, BlueprintReadWrite, meta = ( AllowedClasses = "World" ) )
+    FSoftObjectPath Level;
+
+    UPROPERTY( EditAnywhere, BlueprintReadWrite, meta = ( AllowedClasses = "World" ) )
+    TArray< FSoftObjectPath > Prerequisites;
+};
+
 UCLASS()
 class PORTALLEVELSTREAMING_API UPLSLevelGroup final : public UPrimaryDataAsset
 {
     GENERATED_BODY()
 
 public:
+#if WITH_EDITOR
+    EDataValidationResult IsDataValid( FDataValidationContext & context ) const override;
+#endif
+
     UPROPERTY( EditDefaultsOnly, BlueprintReadWrite, meta = ( AllowedClasses = "World" ) )
     TArray< FSoftObjectPath > Levels;
+
+    // Groups which must be loaded before the levels of this group start loading. They are loaded by the same request, even when not listed by it
+    UPROPERTY( EditDefaultsOnly, BlueprintReadWrite )
+    TArray< UPLSLevelGroup * > Dependencies;
+
+    // Dependencies between the levels of this group. The levels without dependencies are loaded in parallel
+    UPROPERTY( EditDefaultsOnly, BlueprintReadWrite )
+    TArray< FPLSLevelDependency > LevelDependencies;
 };
 
 UENUM()
@@ -22,6 +47,25 @@ enum class EPLSLoadOrder : uint8
     LoadThenUnload
 };
 
+// A level which does not need to be placed in the persistent level : a ULevelStreamingDynamic is created on demand when it must be loaded
+USTRUCT( BlueprintType )
+struct PORTALLEVELSTREAMING_API FPLSLevelInstanceInfos
+{
+    GENERATED_USTRUCT_BODY()
+
+    // Identifies the instance, so the same one can be unloaded later and reused on the next visit. Generated from the package name of the level and the transform when None
+    FName GetInstanceName() const;
+
+    UPROPERTY( EditAnywhere, BlueprintReadWrite )
+    TSoftObjectPtr< UWorld > Level;
+
+    UPROPERTY( EditAnywhere, BlueprintReadWrite )
+    FTransform Transform;
+
+    UPROPERTY( EditAnywhere, BlueprintReadWrite )
+    FName InstanceName;
+};
+
 USTRUCT( BlueprintType )
 struct PORTALLEVELSTREAMING_API FPLSLevelStreamingLevelInfos
 {
@@ -32,6 +76,9 @@ struct PORTALLEVELSTREAMING_API FPLSLevelStreamingLevelInfos
 
     UPROPERTY( EditAnywhere )
     TArray< UPLSLevelGroup * > LevelGroups;
+
+    UPROPERTY( EditAnywhere )
+    TArray< FPLSLevelInstanceInfos > LevelInstances;
 };
 
 UENUM()
@@ -3,6 +3,8 @@
 #include <CoreMinimal.h>
 #include <Modules/ModuleManager.h>
 
+PORTALLEVELSTREAMING_API DECLARE_LOG_CATEGORY_EXTERN( LogPLS, Log, All );
+
 class FPortalLevelStreamingModule final : public IModuleInterface
 {
 public:
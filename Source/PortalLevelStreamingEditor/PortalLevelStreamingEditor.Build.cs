@@ -0,0 +1,26 @@
+using UnrealBuildTool;
+
+public class PortalLevelStreamingEditor : ModuleRules
+{
+	public PortalLevelStreamingEditor(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PublicDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+			}
+			);
+
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"AssetRegistry",
+				"CoreUObject",
+				"Engine",
+				"PortalLevelStreaming",
+			}
+			);
+	}
+}
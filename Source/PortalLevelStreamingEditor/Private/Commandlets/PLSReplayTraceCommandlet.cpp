@@ -0,0 +1,488 @@
+#include "Commandlets/PLSReplayTraceCommandlet.h"
+
+#include "PLSSimulatedStreamingBackend.h"
+#include "PLSSubsystem.h"
+#include "PLSTrace.h"
+#include "PortalLevelStreaming.h"
+
+#include <Algo/Accumulate.h>
+#include <Engine/Engine.h>
+#include <Engine/World.h>
+#include <Misc/App.h>
+#include <TimerManager.h>
+
+namespace
+{
+    struct FLevelTiming
+    {
+        FName PackageName;
+        bool bLoad;
+        double DurationMs;
+    };
+
+    bool HasReachedRequestedState( const FPLSTraceEvent & level_requested_event, const FPLSTraceEvent & level_state_changed_event )
+    {
+        const auto should_be_loaded = level_requested_event.Param0 != 0;
+        const auto should_be_visible = level_requested_event.Param1 != 0;
+        const auto is_loaded = level_state_changed_event.Param0 != 0;
+        const auto is_visible = level_state_changed_event.Param1 != 0;
+
+        if ( should_be_visible )
+        {
+            return is_visible;
+        }
+
+        if ( should_be_loaded )
+        {
+            return is_loaded && !is_visible;
+        }
+
+        return !is_loaded;
+    }
+
+    // Matches each level requested by a request with the transition which made it reach the requested state
+    void GatherLevelTimings( const FPLSTrace & trace, TArray< FLevelTiming > & level_timings, TArray< FName > & pending_level_names )
+    {
+        TMap< FName, const FPLSTraceEvent * > pending_levels;
+
+        for ( const auto & event : trace.Events )
+        {
+            if ( event.Type == EPLSTraceEventType::LevelRequested )
+            {
+                pending_levels.Add( event.LevelPackageName, &event );
+            }
+            else if ( event.Type == EPLSTraceEventType::LevelStateChanged )
+            {
+                if ( const auto * level_requested_event = pending_levels.FindRef( event.LevelPackageName ) )
+                {
+                    if ( HasReachedRequestedState( *level_requested_event, event ) )
+                    {
+                        level_timings.Add( { event.LevelPackageName, level_requested_event->Param0 != 0, ( event.Time - level_requested_event->Time ) * 1000.0 } );
+                        pending_levels.Remove( event.LevelPackageName );
+                    }
+                }
+            }
+        }
+
+        pending_levels.GetKeys( pending_level_names );
+    }
+
+    FPLSLevelStreamingInfos MakeLevelStreamingInfos( const FPLSTraceRequest & trace_request )
+    {
+        FPLSLevelStreamingInfos infos;
+        infos.LoadOrder = trace_request.LoadOrder;
+        // The always loaded levels were already filtered out when the request was recorded
+        infos.AlwaysLoadedLevelsUnloadType = EPLSLevelStreamingAlwaysLoadedLevelsUnloadType::Hide;
+        infos.UnloadCurrentStreamingLevelsInfos.bUnloadCurrentlyLoadedStreamingLevels = false;
+
+        // Dependencies can only be expressed between groups, so each level gets its own transient group when the request has some
+        const auto has_prerequisites = trace_request.LevelsToLoad.ContainsByPredicate( []( const auto & level ) {
+            return !level.Prerequisites.IsEmpty();
+        } );
+        TMap< FName, UPLSLevelGroup * > level_groups;
+
+        for ( const auto & level : trace_request.LevelsToLoad )
+        {
+            auto * levels_to_load = infos.LevelsToLoad.FindByPredicate( [ &level ]( const auto & item ) {
+                return item.bBlockOnLoad == level.bBlockOnLoad && item.LoadType == level.LoadType;
+            } );
+
+            if ( levels_to_load == nullptr )
+            {
+                levels_to_load = &infos.LevelsToLoad.AddDefaulted_GetRef();
+                levels_to_load->bBlockOnLoad = level.bBlockOnLoad;
+                levels_to_load->LoadType = level.LoadType;
+            }
+
+            if ( has_prerequisites )
+            {
+                auto * level_group = NewObject< UPLSLevelGroup >();
+                level_group->Levels.Emplace( level.PackageName.ToString() );
+                levels_to_load->Levels.LevelGroups.Add( level_group );
+                level_groups.Add( level.PackageName, level_group );
+            }
+            else
+            {
+                levels_to_load->Levels.IndividualLevels.Emplace( level.PackageName.ToString() );
+            }
+        }
+
+        for ( const auto & level : trace_request.LevelsToLoad )
+        {
+            for ( const auto prerequisite : level.Prerequisites )
+            {
+                if ( auto * prerequisite_group = level_groups.FindRef( prerequisite ) )
+                {
+                    level_groups.FindChecked( level.PackageName )->Dependencies.Add( prerequisite_group );
+                }
+            }
+        }
+
+        for ( const auto & level : trace_request.LevelsToUnload )
+        {
+            auto * levels_to_unload = infos.LevelsToUnload.FindByPredicate( [ &level ]( const auto & item ) {
+                return item.bBlockOnUnload == level.bBlockOnUnload && item.UnloadType == level.UnloadType;
+            } );
+
+            if ( levels_to_unload == nullptr )
+            {
+                levels_to_unload = &infos.LevelsToUnload.AddDefaulted_GetRef();
+                levels_to_unload->bBlockOnUnload = level.bBlockOnUnload;
+                levels_to_unload->UnloadType = level.UnloadType;
+            }
+
+            levels_to_unload->Levels.IndividualLevels.Emplace( level.PackageName.ToString() );
+        }
+
+        return infos;
+    }
+}
+
+UPLSReplayTraceCommandlet::UPLSReplayTraceCommandlet()
+{
+    IsClient = false;
+    IsEditor = false;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+int32 UPLSReplayTraceCommandlet::Main( const FString & params )
+{
+    FString trace_path;
+    if ( !FParse::Value( *params, TEXT( "Trace=" ), trace_path ) )
+    {
+        UE_LOG( LogPLS, Error, TEXT( "Missing -Trace=<path> argument" ) );
+        return 1;
+    }
+
+    FPLSTrace trace;
+    if ( !trace.LoadFromFile( trace_path ) )
+    {
+        UE_LOG( LogPLS, Error, TEXT( "Could not load the trace %s" ), *trace_path );
+        return 1;
+    }
+
+    auto max_level_count = 20;
+    FParse::Value( *params, TEXT( "MaxLevels=" ), max_level_count );
+
+    UE_LOG( LogPLS, Display, TEXT( "Trace %s : %i requests, %i events" ), *trace_path, trace.Requests.Num(), trace.Events.Num() );
+
+    ReportRequests( trace );
+    ReportLevels( trace, max_level_count );
+
+    if ( FParse::Param( *params, TEXT( "Simulate" ) ) )
+    {
+        return Simulate( trace, params );
+    }
+
+    return 0;
+}
+
+void UPLSReplayTraceCommandlet::ReportRequests( const FPLSTrace & trace ) const
+{
+    struct FRequestTimings
+    {
+        double Added = -1.0;
+        double Started = -1.0;
+        double Finished = -1.0;
+        bool bCancelled = false;
+    };
+
+    TMap< int32, FRequestTimings > request_timings;
+
+    for ( const auto & event : trace.Events )
+    {
+        auto & timings = request_timings.FindOrAdd( event.RequestHandle );
+
+        switch ( event.Type )
+        {
+            case EPLSTraceEventType::RequestAdded:
+            {
+                timings.Added = event.Time;
+            }
+            break;
+            case EPLSTraceEventType::RequestStarted:
+            {
+                if ( timings.Started < 0.0 )
+                {
+                    timings.Started = event.Time;
+                }
+            }
+            break;
+            case EPLSTraceEventType::RequestExecuted:
+            {
+                if ( timings.Finished < 0.0 )
+                {
+                    timings.Finished = event.Time;
+                }
+            }
+            break;
+            case EPLSTraceEventType::RequestCancelled:
+            {
+                timings.bCancelled = true;
+                timings.Finished = event.Time;
+            }
+            break;
+            default:
+            {
+            }
+            break;
+        }
+    }
+
+    UE_LOG( LogPLS, Display, TEXT( "Handle | Loads | Unloads | Queued (ms) | Executed (ms) | Status" ) );
+
+    for ( const auto & request : trace.Requests )
+    {
+        const auto * timings = request_timings.Find( request.RequestHandle );
+        if ( timings == nullptr )
+        {
+            continue;
+        }
+
+        const auto queued_ms = timings->Started >= 0.0 ? ( timings->Started - timings->Added ) * 1000.0 : -1.0;
+        const auto executed_ms = timings->Started >= 0.0 && timings->Finished >= 0.0 ? ( timings->Finished - timings->Started ) * 1000.0 : -1.0;
+        const auto * status = timings->bCancelled ? TEXT( "Cancelled" ) : ( timings->Finished >= 0.0 ? TEXT( "Executed" ) : TEXT( "Pending" ) );
+
+        UE_LOG( LogPLS, Display, TEXT( "%6i | %5i | %7i | %11.2f | %13.2f | %s" ), request.RequestHandle, request.LevelsToLoad.Num(), request.LevelsToUnload.Num(), queued_ms, executed_ms, status );
+    }
+}
+
+void UPLSReplayTraceCommandlet::ReportLevels( const FPLSTrace & trace, const int32 max_level_count ) const
+{
+    TArray< FLevelTiming > level_timings;
+    TArray< FName > pending_level_names;
+    GatherLevelTimings( trace, level_timings, pending_level_names );
+
+    level_timings.Sort( []( const auto & left, const auto & right ) {
+        return left.DurationMs > right.DurationMs;
+    } );
+
+    UE_LOG( LogPLS, Display, TEXT( "Slowest level transitions :" ) );
+
+    for ( auto index = 0; index < FMath::Min( max_level_count, level_timings.Num() ); ++index )
+    {
+        const auto & level_timing = level_timings[ index ];
+        UE_LOG( LogPLS, Display, TEXT( "%10.2f ms | %s | %s" ), level_timing.DurationMs, level_timing.bLoad ? TEXT( "Load  " ) : TEXT( "Unload" ), *level_timing.PackageName.ToString() );
+    }
+
+    for ( const auto level_name : pending_level_names )
+    {
+        UE_LOG( LogPLS, Warning, TEXT( "Level %s never reached its requested state" ), *level_name.ToString() );
+    }
+}
+
+int32 UPLSReplayTraceCommandlet::Simulate( const FPLSTrace & trace, const FString & params ) const
+{
+    auto delta_time = 1.0 / 30.0;
+    auto max_time = 600.0;
+    auto jitter = 0.0f;
+    auto seed = 0;
+    auto level_memory_mb = 0;
+    FPLSSimulatedLevelSettings default_settings;
+    FString output_path;
+
+    FParse::Value( *params, TEXT( "DeltaTime=" ), delta_time );
+    FParse::Value( *params, TEXT( "MaxTime=" ), max_time );
+    FParse::Value( *params, TEXT( "Jitter=" ), jitter );
+    FParse::Value( *params, TEXT( "Seed=" ), seed );
+    FParse::Value( *params, TEXT( "LevelMemoryMB=" ), level_memory_mb );
+    FParse::Value( *params, TEXT( "LoadLatency=" ), default_settings.LoadLatency );
+    FParse::Value( *params, TEXT( "VisibilityLatency=" ), default_settings.VisibilityLatency );
+    FParse::Value( *params, TEXT( "Output=" ), output_path );
+    default_settings.MemoryCost = static_cast< int64 >( level_memory_mb ) * 1024 * 1024;
+
+    // Optionally reuse the load time measured for each level in the recorded session
+    TMap< FName, double > measured_load_latencies;
+    if ( FParse::Param( *params, TEXT( "UseMeasuredLatencies" ) ) )
+    {
+        TArray< FLevelTiming > level_timings;
+        TArray< FName > pending_level_names;
+        GatherLevelTimings( trace, level_timings, pending_level_names );
+
+        for ( const auto & level_timing : level_timings )
+        {
+            if ( level_timing.bLoad )
+            {
+                auto & latency = measured_load_latencies.FindOrAdd( level_timing.PackageName, 0.0 );
+                latency = FMath::Max( latency, level_timing.DurationMs / 1000.0 );
+            }
+        }
+    }
+
+    const auto backend = MakeShared< FPLSSimulatedStreamingBackend >( seed, jitter );
+
+    const auto add_level = [ &backend, &default_settings, &measured_load_latencies ]( const FName level_name ) {
+        auto settings = default_settings;
+        if ( const auto * latency = measured_load_latencies.Find( level_name ) )
+        {
+            settings.LoadLatency = *latency;
+        }
+        backend->AddLevel( level_name, settings );
+    };
+
+    for ( const auto & trace_request : trace.Requests )
+    {
+        for ( const auto & level : trace_request.LevelsToLoad )
+        {
+            add_level( level.PackageName );
+        }
+        for ( const auto & level : trace_request.LevelsToUnload )
+        {
+            add_level( level.PackageName );
+        }
+    }
+
+    auto * world = UWorld::CreateWorld( EWorldType::Game, false, TEXT( "PLSReplayTrace" ) );
+    auto & world_context = GEngine->CreateNewWorldContext( EWorldType::Game );
+    world_context.SetCurrentWorld( world );
+
+    auto * pls_subsystem = world->GetSubsystem< UPLSSubsystem >();
+    if ( pls_subsystem == nullptr )
+    {
+        UE_LOG( LogPLS, Error, TEXT( "The simulation world has no PLS subsystem" ) );
+        GEngine->DestroyWorldContext( world );
+        world->DestroyWorld( false );
+        return 1;
+    }
+
+    pls_subsystem->SetBackend( backend );
+    pls_subsystem->SetLoadingScreenVisible( FParse::Param( *params, TEXT( "LoadingScreen" ) ) );
+
+    if ( !output_path.IsEmpty() )
+    {
+        pls_subsystem->StartTraceRecording();
+    }
+
+    struct FSimulatedRequest
+    {
+        int32 RecordedHandle;
+        double Added;
+        double Executed;
+        bool bCancelled;
+    };
+
+    // The requests are added and cancelled in the order they were recorded
+    TMap< int32, const FPLSTraceRequest * > trace_requests;
+    for ( const auto & trace_request : trace.Requests )
+    {
+        trace_requests.Add( trace_request.RequestHandle, &trace_request );
+    }
+
+    TArray< const FPLSTraceEvent * > request_events;
+    for ( const auto & event : trace.Events )
+    {
+        if ( ( event.Type == EPLSTraceEventType::RequestAdded && trace_requests.Contains( event.RequestHandle ) ) || event.Type == EPLSTraceEventType::RequestCancelled )
+        {
+            request_events.Add( &event );
+        }
+    }
+
+    TMap< FPLSLevelStreamingRequestHandle, FSimulatedRequest > simulated_requests;
+    TMap< int32, FPLSLevelStreamingRequestHandle > recorded_to_simulated_handles;
+    TSet< FPLSLevelStreamingRequestHandle > pending_handles;
+    TArray< double > frame_times;
+    auto next_event_index = 0;
+    auto frame_count = 0;
+
+    while ( next_event_index < request_events.Num() || pending_handles.Num() > 0 )
+    {
+        if ( backend->GetTimeSeconds() > max_time )
+        {
+            UE_LOG( LogPLS, Warning, TEXT( "The simulation did not finish after %.2f seconds, %i requests still pending" ), max_time, pending_handles.Num() );
+            break;
+        }
+
+        while ( next_event_index < request_events.Num() && request_events[ next_event_index ]->Time <= backend->GetTimeSeconds() )
+        {
+            const auto & event = *request_events[ next_event_index++ ];
+
+            if ( event.Type == EPLSTraceEventType::RequestCancelled )
+            {
+                // Includes the cancellations caused by bCancelExistingRequests : they are recorded before the request which caused them
+                if ( const auto * handle = recorded_to_simulated_handles.Find( event.RequestHandle ) )
+                {
+                    if ( pls_subsystem->CancelRequest( *handle ) )
+                    {
+                        simulated_requests.FindChecked( *handle ).bCancelled = true;
+                    }
+                    pending_handles.Remove( *handle );
+                }
+                continue;
+            }
+
+            const auto & trace_request = *trace_requests.FindChecked( event.RequestHandle );
+
+            if ( trace_request.bCancelExistingRequests )
+            {
+                pending_handles.Reset();
+            }
+
+            const auto executed_delegate = FPLSOnRequestExecutedDelegate::CreateLambda( [ &simulated_requests, &pending_handles, backend ]( const FPLSLevelStreamingRequestHandle handle ) {
+                if ( auto * simulated_request = simulated_requests.Find( handle ) )
+                {
+                    simulated_request->Executed = backend->GetTimeSeconds();
+                }
+                pending_handles.Remove( handle );
+            } );
+
+            const auto handle = pls_subsystem->AddRequest( MakeLevelStreamingInfos( trace_request ), executed_delegate, trace_request.bCancelExistingRequests );
+            simulated_requests.Add( handle, { trace_request.RequestHandle, backend->GetTimeSeconds(), -1.0, false } );
+            recorded_to_simulated_handles.Add( trace_request.RequestHandle, handle );
+            pending_handles.Add( handle );
+        }
+
+        const auto blocking_time_before_tick = backend->GetBlockingTime();
+        backend->Tick( delta_time );
+
+        // Blocking transitions stall the frame they complete in
+        const auto frame_time = delta_time + ( backend->GetBlockingTime() - blocking_time_before_tick );
+        frame_times.Add( frame_time );
+
+        // The timer manager only ticks once per frame
+        GFrameCounter++;
+        world->GetTimerManager().Tick( delta_time );
+        // The throttle reads the duration of the frame from FApp, like in game
+        FApp::SetDeltaTime( frame_time );
+        pls_subsystem->Tick( delta_time );
+        frame_count++;
+    }
+
+    frame_times.Sort();
+    const auto average_frame_time = frame_times.IsEmpty() ? 0.0 : Algo::Accumulate( frame_times, 0.0 ) / frame_times.Num();
+    const auto p99_frame_time = frame_times.IsEmpty() ? 0.0 : frame_times[ FMath::Min( frame_times.Num() - 1, FMath::FloorToInt( frame_times.Num() * 0.99 ) ) ];
+
+    UE_LOG( LogPLS, Display, TEXT( "Simulation : %i frames, %.2f s, peak memory %.2f MB, final memory %.2f MB, blocking time %.2f ms" ), frame_count, backend->GetTimeSeconds(), backend->GetPeakMemoryUsage() / ( 1024.0 * 1024.0 ), backend->GetMemoryUsage() / ( 1024.0 * 1024.0 ), backend->GetBlockingTime() * 1000.0 );
+    UE_LOG( LogPLS, Display, TEXT( "Frame time : average %.2f ms, 99th percentile %.2f ms, max %.2f ms" ), average_frame_time * 1000.0, p99_frame_time * 1000.0, frame_times.IsEmpty() ? 0.0 : frame_times.Last() * 1000.0 );
+
+    if ( backend->GetTransitioningLevelCount() > 0 )
+    {
+        UE_LOG( LogPLS, Warning, TEXT( "%i levels did not reach their requested state by the end of the simulation" ), backend->GetTransitioningLevelCount() );
+    }
+
+    UE_LOG( LogPLS, Display, TEXT( "Recorded handle | Added (s) | Executed after (ms)" ) );
+
+    for ( const auto & pair : simulated_requests )
+    {
+        const auto & simulated_request = pair.Value;
+
+        if ( simulated_request.Executed >= 0.0 )
+        {
+            UE_LOG( LogPLS, Display, TEXT( "%15i | %9.3f | %19.2f" ), simulated_request.RecordedHandle, simulated_request.Added, ( simulated_request.Executed - simulated_request.Added ) * 1000.0 );
+        }
+        else
+        {
+            UE_LOG( LogPLS, Display, TEXT( "%15i | %9.3f | %19s" ), simulated_request.RecordedHandle, simulated_request.Added, simulated_request.bCancelled ? TEXT( "Cancelled" ) : TEXT( "Not executed" ) );
+        }
+    }
+
+    if ( !output_path.IsEmpty() )
+    {
+        pls_subsystem->StopTraceRecording( output_path );
+    }
+
+    GEngine->DestroyWorldContext( world );
+    world->DestroyWorld( false );
+
+    return 0;
+}
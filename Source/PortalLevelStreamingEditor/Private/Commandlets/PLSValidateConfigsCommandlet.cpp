@@ -0,0 +1,229 @@
+#include "Commandlets/PLSValidateConfigsCommandlet.h"
+
+#include "PLSConfigValidator.h"
+#include "PLSTypes.h"
+#include "PortalLevelStreaming.h"
+
+#include <AssetRegistry/AssetRegistryModule.h>
+#include <Engine/Blueprint.h>
+#include <Engine/Level.h>
+#include <Engine/LevelStreaming.h>
+#include <Engine/World.h>
+#include <GameFramework/Actor.h>
+#include <Misc/Paths.h>
+
+namespace
+{
+    typedef TArray< TPair< FString, const FPLSLevelStreamingInfos * > > FStreamingInfosArray;
+
+    // Finds the FPLSLevelStreamingInfos in the properties of container, including in nested structs and arrays of structs
+    void GatherStreamingInfos( const UStruct & struct_type, const void * container, const FString & prefix, FStreamingInfosArray & streaming_infos )
+    {
+        const auto * streaming_infos_struct = FPLSLevelStreamingInfos::StaticStruct();
+
+        const auto gather_struct = [ & ]( const UScriptStruct & value_struct, const void * value, const FString & name ) {
+            if ( &value_struct == streaming_infos_struct )
+            {
+                streaming_infos.Emplace( name, static_cast< const FPLSLevelStreamingInfos * >( value ) );
+            }
+            else
+            {
+                GatherStreamingInfos( value_struct, value, name + TEXT( "." ), streaming_infos );
+            }
+        };
+
+        for ( TFieldIterator< FProperty > iterator( &struct_type ); iterator; ++iterator )
+        {
+            const auto * property = *iterator;
+
+            if ( const auto * struct_property = CastField< FStructProperty >( property ) )
+            {
+                gather_struct( *struct_property->Struct, struct_property->ContainerPtrToValuePtr< void >( container ), prefix + property->GetName() );
+            }
+            else if ( const auto * array_property = CastField< FArrayProperty >( property ) )
+            {
+                if ( const auto * inner_property = CastField< FStructProperty >( array_property->Inner ) )
+                {
+                    FScriptArrayHelper array_helper( array_property, array_property->ContainerPtrToValuePtr< void >( container ) );
+
+                    for ( auto index = 0; index < array_helper.Num(); ++index )
+                    {
+                        gather_struct( *inner_property->Struct, array_helper.GetRawPtr( index ), FString::Printf( TEXT( "%s%s[%i]" ), *prefix, *property->GetName(), index ) );
+                    }
+                }
+            }
+        }
+    }
+
+    void GetAssets( const FTopLevelAssetPath & class_path, TArray< FAssetData > & assets )
+    {
+        auto & asset_registry = FModuleManager::LoadModuleChecked< FAssetRegistryModule >( TEXT( "AssetRegistry" ) ).Get();
+        asset_registry.SearchAllAssets( true );
+
+        FARFilter filter;
+        filter.ClassPaths.Add( class_path );
+        filter.PackagePaths.Add( TEXT( "/Game" ) );
+        filter.bRecursivePaths = true;
+
+        asset_registry.GetAssets( filter, assets );
+    }
+}
+
+UPLSValidateConfigsCommandlet::UPLSValidateConfigsCommandlet()
+{
+    IsClient = false;
+    IsEditor = true;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+int32 UPLSValidateConfigsCommandlet::Main( const FString & params )
+{
+    FPLSConfigValidator validator;
+
+    ValidateLevelGroups( validator );
+
+    if ( !FParse::Param( *params, TEXT( "SkipBlueprints" ) ) )
+    {
+        ValidateBlueprints( validator );
+    }
+
+    if ( !FParse::Param( *params, TEXT( "SkipMaps" ) ) )
+    {
+        ValidateMaps( validator, params );
+    }
+
+    validator.ComputeOverlaps();
+    validator.LogReport();
+
+    FString report_path;
+    if ( !FParse::Value( *params, TEXT( "Report=" ), report_path ) )
+    {
+        report_path = FPaths::ProjectSavedDir() / TEXT( "PLS" ) / FString::Printf( TEXT( "ValidationReport-%s.csv" ), *FDateTime::Now().ToString() );
+    }
+
+    if ( validator.SaveReport( report_path ) )
+    {
+        UE_LOG( LogPLS, Display, TEXT( "Report saved to %s" ), *report_path );
+    }
+    else
+    {
+        UE_LOG( LogPLS, Error, TEXT( "Could not save the report to %s" ), *report_path );
+    }
+
+    return FParse::Param( *params, TEXT( "FailOnErrors" ) ) && validator.GetErrorCount() > 0 ? 1 : 0;
+}
+
+void UPLSValidateConfigsCommandlet::ValidateLevelGroups( FPLSConfigValidator & validator ) const
+{
+    TArray< FAssetData > assets;
+    GetAssets( UPLSLevelGroup::StaticClass()->GetClassPathName(), assets );
+
+    for ( const auto & asset : assets )
+    {
+        if ( const auto * level_group = Cast< UPLSLevelGroup >( asset.GetAsset() ) )
+        {
+            validator.ValidateLevelGroup( *level_group );
+        }
+    }
+
+    UE_LOG( LogPLS, Display, TEXT( "Validated %i level groups" ), assets.Num() );
+}
+
+void UPLSValidateConfigsCommandlet::ValidateBlueprints( FPLSConfigValidator & validator ) const
+{
+    TArray< FAssetData > assets;
+    GetAssets( UBlueprint::StaticClass()->GetClassPathName(), assets );
+
+    for ( const auto & asset : assets )
+    {
+        const auto * blueprint = Cast< UBlueprint >( asset.GetAsset() );
+        if ( blueprint == nullptr || blueprint->GeneratedClass == nullptr )
+        {
+            continue;
+        }
+
+        // The world is not known : the levels can only be checked to exist
+        ValidateObject( validator, *blueprint->GeneratedClass->GetDefaultObject(), blueprint->GetPathName(), nullptr );
+    }
+
+    CollectGarbage( GARBAGE_COLLECTION_KEEPFLAGS );
+}
+
+void UPLSValidateConfigsCommandlet::ValidateMaps( FPLSConfigValidator & validator, const FString & params ) const
+{
+    TArray< FString > map_package_names;
+
+    FString maps;
+    if ( FParse::Value( *params, TEXT( "Maps=" ), maps, false ) )
+    {
+        maps.ParseIntoArray( map_package_names, TEXT( "+" ) );
+    }
+    else
+    {
+        TArray< FAssetData > assets;
+        GetAssets( UWorld::StaticClass()->GetClassPathName(), assets );
+
+        for ( const auto & asset : assets )
+        {
+            map_package_names.Add( asset.PackageName.ToString() );
+        }
+    }
+
+    for ( const auto & map_package_name : map_package_names )
+    {
+        auto * package = LoadPackage( nullptr, *map_package_name, LOAD_None );
+        const auto * world = package != nullptr ? UWorld::FindWorldInPackage( package ) : nullptr;
+
+        if ( world == nullptr || world->PersistentLevel == nullptr )
+        {
+            UE_LOG( LogPLS, Error, TEXT( "Could not load the map %s" ), *map_package_name );
+            continue;
+        }
+
+        TSet< FName > streaming_levels;
+        for ( const auto * level_streaming : world->GetStreamingLevels() )
+        {
+            if ( level_streaming != nullptr )
+            {
+                streaming_levels.Add( level_streaming->GetWorldAssetPackageFName() );
+            }
+        }
+
+        // A map without streaming levels is most likely a sub level : its portals resolve the levels of a persistent level we don't know about
+        const auto * known_streaming_levels = streaming_levels.IsEmpty() ? nullptr : &streaming_levels;
+
+        for ( const auto * actor : world->PersistentLevel->Actors )
+        {
+            if ( actor == nullptr )
+            {
+                continue;
+            }
+
+            ValidateObject( validator, *actor, actor->GetPathName(), known_streaming_levels );
+
+            for ( const auto * component : actor->GetComponents() )
+            {
+                if ( component != nullptr )
+                {
+                    ValidateObject( validator, *component, component->GetPathName(), known_streaming_levels );
+                }
+            }
+        }
+
+        CollectGarbage( GARBAGE_COLLECTION_KEEPFLAGS );
+    }
+
+    UE_LOG( LogPLS, Display, TEXT( "Validated %i maps" ), map_package_names.Num() );
+}
+
+void UPLSValidateConfigsCommandlet::ValidateObject( FPLSConfigValidator & validator, const UObject & object, const FString & owner, const TSet< FName > * streaming_levels ) const
+{
+    FStreamingInfosArray streaming_infos;
+    GatherStreamingInfos( *object.GetClass(), &object, TEXT( "" ), streaming_infos );
+
+    for ( const auto & pair : streaming_infos )
+    {
+        validator.ValidateStreamingInfos( FString::Printf( TEXT( "%s:%s" ), *owner, *pair.Key ), *pair.Value, streaming_levels );
+    }
+}
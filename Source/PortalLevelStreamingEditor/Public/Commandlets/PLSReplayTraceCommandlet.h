@@ -0,0 +1,30 @@
+#pragma once
+
+#include <Commandlets/Commandlet.h>
+#include <CoreMinimal.h>
+
+#include "PLSReplayTraceCommandlet.generated.h"
+
+class FPLSTrace;
+
+/*
+ * Reads a trace recorded with PLS.Trace.Start / PLS.Trace.Stop and reports the timings of the requests and of their levels.
+ * With -Simulate, the requests of the trace are added and cancelled again through UPLSSubsystem on top of a FPLSSimulatedStreamingBackend, so the scheduling can be profiled without any content.
+ * Usage : -run=PLSReplayTrace -Trace=<path to the .plstrace file> [-MaxLevels=20]
+ *         [-Simulate [-DeltaTime=0.0333] [-LoadLatency=0.1] [-VisibilityLatency=0.016] [-UseMeasuredLatencies] [-LevelMemoryMB=0] [-Seed=0] [-Jitter=0] [-LoadingScreen] [-Output=<path of the simulated trace>]]
+ */
+UCLASS()
+class PORTALLEVELSTREAMINGEDITOR_API UPLSReplayTraceCommandlet final : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UPLSReplayTraceCommandlet();
+
+    int32 Main( const FString & params ) override;
+
+private:
+    void ReportRequests( const FPLSTrace & trace ) const;
+    void ReportLevels( const FPLSTrace & trace, int32 max_level_count ) const;
+    int32 Simulate( const FPLSTrace & trace, const FString & params ) const;
+};
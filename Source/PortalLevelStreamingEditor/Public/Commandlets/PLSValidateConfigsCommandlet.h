@@ -0,0 +1,30 @@
+#pragma once
+
+#include <Commandlets/Commandlet.h>
+#include <CoreMinimal.h>
+
+#include "PLSValidateConfigsCommandlet.generated.h"
+
+class FPLSConfigValidator;
+
+/*
+ * Validates all the level groups, and all the FPLSLevelStreamingInfos found in the properties of the actors of the maps and of the blueprints,
+ * then writes a CSV report with the cost of each transition, which can be compared between builds.
+ * Usage : -run=PLSValidateConfigs [-Maps=/Game/Maps/MapA+/Game/Maps/MapB] [-SkipMaps] [-SkipBlueprints] [-Report=<path of the csv file>] [-FailOnErrors]
+ */
+UCLASS()
+class PORTALLEVELSTREAMINGEDITOR_API UPLSValidateConfigsCommandlet final : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UPLSValidateConfigsCommandlet();
+
+    int32 Main( const FString & params ) override;
+
+private:
+    void ValidateLevelGroups( FPLSConfigValidator & validator ) const;
+    void ValidateBlueprints( FPLSConfigValidator & validator ) const;
+    void ValidateMaps( FPLSConfigValidator & validator, const FString & params ) const;
+    void ValidateObject( FPLSConfigValidator & validator, const UObject & object, const FString & owner, const TSet< FName > * streaming_levels ) const;
+};